@@ -0,0 +1,90 @@
+/**
+ * @file    concurrent_html_builder.cpp
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#include "concurrent_html_builder.h"
+
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+ConcurrentHtmlBuilder::ConcurrentHtmlBuilder(std::string_view rootName, std::size_t shardCount)
+: m_root(rootName)
+{
+    m_shards.reserve(shardCount);
+    for (std::size_t i = 0; i < shardCount; ++i)
+    {
+        // The arenas are allocated one after the other, padding keeps them from sharing a line.
+        auto padded = std::make_shared<PaddedStrings>();
+        m_shards.push_back(
+          Slot {HtmlBuilder {rootName, std::shared_ptr<StringArena> {padded, &padded->Strings}}});
+    }
+}
+
+HtmlElement ConcurrentHtmlBuilder::Build() &&
+{
+    // Every shard is checked before anything is moved, so that a failure leaves them all intact.
+    for (std::size_t i = 0; i < m_shards.size(); ++i)
+    {
+        if (m_shards[i].Builder.HasOpenElement())
+        {
+            throw std::logic_error("Cannot build while an element is still open in shard " +
+                                   std::to_string(i));
+        }
+    }
+
+    std::vector<HtmlElement> parts;
+    parts.reserve(m_shards.size());
+    for (auto& shard : m_shards)
+    {
+        parts.push_back(std::move(shard.Builder).Build());
+    }
+
+    HtmlElement root  = std::move(m_root).Build();
+    std::size_t count = 0;
+    for (const auto& part : parts)
+    {
+        count += part.Elements.size();
+    }
+    root.Elements.reserve(count);
+
+    for (auto& part : parts)
+    {
+        root.Elements.insert(root.Elements.end(),
+                             std::make_move_iterator(part.Elements.begin()),
+                             std::make_move_iterator(part.Elements.end()));
+
+        // A copy of the shard built before could still be using its strings, in which case they
+        // are shared rather than taken.
+        if (part.Strings.use_count() == 1)
+        {
+            root.Strings->Adopt(std::move(*part.Strings));
+        }
+        else
+        {
+            root.Strings->KeepAlive(std::move(part.Strings));
+        }
+    }
+    return root;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file    concurrent_html_builder.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_CONCURRENT_HTML_BUILDER_H
+#define DESIGN_PATTERNS_CONCURRENT_HTML_BUILDER_H
+
+#include <cstddef>
+#include <string_view>
+#include <vector>
+
+#include "html_builder.h"
+#include "html_element.h"
+#include "string_arena.h"
+
+/**
+ * A builder whose children are added by several threads at once, each one into its own shard.
+ *
+ * The shards are made up front, each one on cache lines of its own along with the arena of its
+ * strings, so adding to them takes no lock and the threads don't take cache lines from each
+ * other. Build() then puts the children of every shard under the root, in the order of the
+ * shards. That order can be the one of the threads, of the parts of the work, or of any sequence
+ * number that the parts are known by in advance, and doesn't depend on which thread finished
+ * first:
+ *  ConcurrentHtmlBuilder report("body", parts.size());
+ *  // On as many threads as needed, each part i going to its own shard:
+ *  report.Shard(i).Open("section").AddChild("h2", parts[i].Title).Close();
+ *  HtmlElement body = std::move(report).Build();
+ *
+ * The children are moved from the shards and the strings of the shards are taken over by the
+ * root, so merging them copies neither elements nor strings.
+ */
+class ConcurrentHtmlBuilder
+{
+public:
+    ConcurrentHtmlBuilder(std::string_view rootName, std::size_t shardCount);
+
+    /**
+     * The builder of shard @c index, which only one thread may use at a time.
+     *
+     * @throws std::out_of_range if there is no such shard.
+     */
+    [[nodiscard]] HtmlBuilder& Shard(std::size_t index) { return m_shards.at(index).Builder; }
+
+    [[nodiscard]] std::size_t ShardCount() const { return m_shards.size(); }
+
+    /**
+     * Moves the children of every shard under the root, in the order of the shards.
+     *
+     * Must only be called once every thread is done with its shard.
+     *
+     * @throws std::logic_error if an element is still open in a shard.
+     */
+    [[nodiscard]] HtmlElement Build() &&;
+
+private:
+    // Shards are written to by different threads, which would otherwise keep taking the cache lines
+    // of their neighbours from each other.
+    static constexpr std::size_t CacheLineSize = 64;
+
+    struct alignas(CacheLineSize) Slot
+    {
+        HtmlBuilder Builder;
+    };
+
+    //! The arena of a shard, which is written to with every string added and is allocated apart.
+    struct alignas(CacheLineSize) PaddedStrings
+    {
+        StringArena Strings;
+    };
+
+    HtmlBuilder       m_root;
+    std::vector<Slot> m_shards;
+};
+
+#endif    // DESIGN_PATTERNS_CONCURRENT_HTML_BUILDER_H
@@ -25,10 +25,93 @@
 
 #include "html_element.h"
 
-HtmlBuilder& HtmlBuilder::AddChild(std::string_view name, std::string_view text)
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+HtmlBuilder::HtmlBuilder(std::string_view rootName)
+: HtmlBuilder(rootName, std::make_shared<StringArena>())
+{
+}
+
+HtmlBuilder::HtmlBuilder(std::string_view rootName, std::shared_ptr<StringArena> strings)
+{
+    Root.Strings = std::move(strings);
+    Root.Name    = Root.Strings->Intern(rootName);
+}
+
+HtmlBuilder& HtmlBuilder::AddChild(std::string_view name, std::string_view text) &
+{
+    auto& strings = *Root.Strings;
+    Current().Elements.push_back(HtmlElement {strings.Intern(name), strings.Store(text)});
+
+    return *this;
+}
+
+HtmlBuilder& HtmlBuilder::AddChild(HtmlElement child) &
+{
+    Current().Elements.push_back(std::move(child));
+
+    return *this;
+}
+
+HtmlBuilder& HtmlBuilder::Open(std::string_view name, std::string_view text) &
+{
+    auto& strings  = *Root.Strings;
+    auto& elements = Current().Elements;
+    elements.push_back(HtmlElement {strings.Intern(name), strings.Store(text)});
+    m_open.push_back(&elements.back());
+
+    return *this;
+}
+
+HtmlBuilder& HtmlBuilder::Close() &
 {
-    HtmlElement elem {name, text};
-    Root.Elements.push_back(elem);
+    if (m_open.empty())
+    {
+        throw std::logic_error("No element is open");
+    }
+    m_open.pop_back();
 
     return *this;
 }
+
+HtmlElement HtmlBuilder::Build() &&
+{
+    if (!m_open.empty())
+    {
+        throw std::logic_error("Cannot build while an element is still open");
+    }
+    return std::move(Root);
+}
+
+void HtmlBuilder::Reserve(std::vector<HtmlElement>& elements, std::size_t count)
+{
+    const std::size_t needed = elements.size() + count;
+    if (needed > elements.capacity())
+    {
+        // Reserving just what is needed would make a loop of small additions quadratic.
+        elements.reserve(std::max(needed, 2 * elements.capacity()));
+    }
+}
+
+void HtmlBuilder::Merge(std::vector<Shard>& shards)
+{
+    auto&       elements = Current().Elements;
+    std::size_t count    = 0;
+    for (const auto& shard : shards)
+    {
+        count += shard.Elements.size();
+    }
+    Reserve(elements, count);
+
+    for (auto& shard : shards)
+    {
+        elements.insert(elements.end(),
+                        std::make_move_iterator(shard.Elements.begin()),
+                        std::make_move_iterator(shard.Elements.end()));
+        Root.Strings->Adopt(std::move(shard.Strings));
+    }
+}
@@ -25,30 +25,270 @@
 #ifndef DESIGN_PATTERNS_HTML_BUILDER_H
 #define DESIGN_PATTERNS_HTML_BUILDER_H
 
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <ranges>
 #include <string>
 #include <string_view>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "html_element.h"
+#include "string_arena.h"
+
+/**
+ * How HtmlBuilder::AddChildren shares the children between threads.
+ */
+struct ParallelFill
+{
+    //! Number of threads filling the children, including the calling one. 0 counts as 1.
+    unsigned int Threads = std::max(std::thread::hardware_concurrency(), 1U);
+    //! Fewest children given to a thread, below which starting it costs more than it saves.
+    std::size_t MinChildrenPerThread = 16384;
+};
 
 /**
  * The builder that allows us to simply and neatly create our HTML elements.
+ *
+ * Children can be nested to any depth, either by opening and closing them:
+ *  HtmlElement::Create("ul").Open("li").AddChild("b", "hello").Close().Build();
+ * or by filling them from a function:
+ *  HtmlElement::Create("ul").AddChild("li", [](HtmlBuilder& li) { li.AddChild("b", "hello"); });
+ *
+ * The names and texts are copied into a string arena that the built tree owns, so they can come
+ * from strings that don't outlive the builder. Names are only stored once.
+ *
+ * Every element is built in place, in the tree that Build() hands out. The builder is move-only,
+ * and building from an rvalue moves that tree out, so a whole document is made without copying
+ * any element.
  */
 class HtmlBuilder
 {
 public:
-    HtmlBuilder(std::string_view rootName) : Root(rootName) {}
+    HtmlBuilder(std::string_view rootName);
+
+    HtmlBuilder(const HtmlBuilder&)            = delete;
+    HtmlBuilder& operator=(const HtmlBuilder&) = delete;
+    HtmlBuilder(HtmlBuilder&&) noexcept        = default;
+    HtmlBuilder& operator=(HtmlBuilder&&)      = default;
+    ~HtmlBuilder()                             = default;
+
+    //! Adds a child to the element currently open, the root if none is.
+    HtmlBuilder&  AddChild(std::string_view name, std::string_view text) &;
+    HtmlBuilder&& AddChild(std::string_view name, std::string_view text) &&
+    {
+        return std::move(AddChild(name, text));
+    }
+
+    //! Adds an element that was built beforehand, along with its own children.
+    HtmlBuilder&  AddChild(HtmlElement child) &;
+    HtmlBuilder&& AddChild(HtmlElement child) && { return std::move(AddChild(std::move(child))); }
+
+    /**
+     * Adds a child, then calls @c fill with the builder to add the children of that child.
+     */
+    template<std::invocable<HtmlBuilder&> Func>
+    HtmlBuilder& AddChild(std::string_view name, Func&& fill) &
+    {
+        Open(name);
+        std::forward<Func>(fill)(*this);
+        return Close();
+    }
+    template<std::invocable<HtmlBuilder&> Func>
+    HtmlBuilder&& AddChild(std::string_view name, Func&& fill) &&
+    {
+        return std::move(AddChild(name, std::forward<Func>(fill)));
+    }
+
+    /**
+     * Adds a child named @c name for each item of @c items, whose text is the item passed through
+     * @c proj.
+     *
+     * The texts are added after one another, reserving room for all of them at once when the
+     * size of @c items is known.
+     */
+    template<std::ranges::input_range R, typename Proj = std::identity>
+        requires std::convertible_to<std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>,
+                                     std::string_view>
+    HtmlBuilder& AddChildren(std::string_view name, R&& items, Proj proj = {}) &
+    {
+        auto& strings  = *Root.Strings;
+        auto& elements = Current().Elements;
+        if constexpr (std::ranges::sized_range<R>)
+        {
+            Reserve(elements, std::ranges::size(items));
+        }
+
+        name = strings.Intern(name);
+        for (auto&& item : items)
+        {
+            elements.push_back(HtmlElement {
+              name, strings.Store(std::invoke(proj, std::forward<decltype(item)>(item)))});
+        }
+        return *this;
+    }
+    template<std::ranges::input_range R, typename Proj = std::identity>
+        requires std::convertible_to<std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>,
+                                     std::string_view>
+    HtmlBuilder&& AddChildren(std::string_view name, R&& items, Proj proj = {}) &&
+    {
+        return std::move(AddChildren(name, std::forward<R>(items), std::move(proj)));
+    }
 
-    HtmlBuilder& AddChild(std::string_view name, std::string_view text);
+    /**
+     * Same as AddChildren(name, items, proj), with the items split into contiguous parts that are
+     * filled on several threads. The children end up in the same order either way.
+     *
+     * @c proj is called from all of these threads at once, and must allow it.
+     */
+    template<std::ranges::forward_range R, typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::convertible_to<std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>,
+                                     std::string_view>
+    HtmlBuilder& AddChildren(const ParallelFill& fill,
+                             std::string_view    name,
+                             R&&                 items,
+                             Proj                proj = {}) &
+    {
+        const std::size_t count  = std::ranges::size(items);
+        // No threads at all is taken as the calling one alone.
+        const std::size_t shards =
+          std::clamp<std::size_t>(count / std::max<std::size_t>(fill.MinChildrenPerThread, 1),
+                                  1,
+                                  std::max(fill.Threads, 1U));
+        if (shards == 1)
+        {
+            return AddChildren(name, std::forward<R>(items), std::move(proj));
+        }
+
+        name = Root.Strings->Intern(name);
+        std::vector<Shard> parts(shards);
+        std::exception_ptr error;
+        std::mutex         errorMutex;
+        {
+            std::vector<std::jthread> pool;
+            auto                      first = std::ranges::begin(items);
+            for (std::size_t i = 0; i < shards; ++i)
+            {
+                const std::size_t size = count / shards + (i < count % shards ? 1 : 0);
+                const auto        last = std::ranges::next(first, size);
+                auto work = [&, first, last, size, &shard = parts[i]]
+                {
+                    try
+                    {
+                        shard.Elements.reserve(size);
+                        for (auto it = first; it != last; ++it)
+                        {
+                            shard.Elements.push_back(
+                              HtmlElement {name, shard.Strings.Store(std::invoke(proj, *it))});
+                        }
+                    }
+                    catch (...)
+                    {
+                        std::scoped_lock lock {errorMutex};
+                        error = std::current_exception();
+                    }
+                };
+
+                // The last part is filled by the calling thread.
+                if (i + 1 < shards)
+                {
+                    pool.emplace_back(std::move(work));
+                }
+                else
+                {
+                    work();
+                }
+                first = last;
+            }
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+        Merge(parts);
+        return *this;
+    }
+    template<std::ranges::forward_range R, typename Proj = std::identity>
+        requires std::ranges::sized_range<R> &&
+                 std::convertible_to<std::indirect_result_t<Proj&, std::ranges::iterator_t<R>>,
+                                     std::string_view>
+    HtmlBuilder&& AddChildren(const ParallelFill& fill,
+                              std::string_view    name,
+                              R&&                 items,
+                              Proj                proj = {}) &&
+    {
+        return std::move(AddChildren(fill, name, std::forward<R>(items), std::move(proj)));
+    }
+
+    /**
+     * Adds a child and makes it the element that the next children are added to, until Close().
+     */
+    HtmlBuilder&  Open(std::string_view name, std::string_view text = {}) &;
+    HtmlBuilder&& Open(std::string_view name, std::string_view text = {}) &&
+    {
+        return std::move(Open(name, text));
+    }
+
+    /**
+     * Goes back to adding children to the parent of the element currently open.
+     *
+     * @throws std::logic_error if no element is open.
+     */
+    HtmlBuilder&  Close() &;
+    HtmlBuilder&& Close() && { return std::move(Close()); }
 
     [[nodiscard]] std::string ToStr() const { return Root.ToStr(); }
 
-    [[nodiscard]] HtmlElement Build() const { return Root; }
+    //! Whether Close() still has to be called before building.
+    [[nodiscard]] bool HasOpenElement() const { return !m_open.empty(); }
+
+    [[nodiscard]] const StringArena& Strings() const { return *Root.Strings; }
+
+    //! Copies the tree, leaving the builder untouched.
+    [[nodiscard]] HtmlElement Build() const& { return Root; }
+    /**
+     * Moves the tree out of the builder.
+     *
+     * @throws std::logic_error if an element is still open.
+     */
+    [[nodiscard]] HtmlElement Build() &&;
 
-    operator HtmlElement() const { return Root; }
+    operator HtmlElement() const& { return Root; }
+    operator HtmlElement() && { return std::move(*this).Build(); }
 
 private:
+    friend class ConcurrentHtmlBuilder;
+
     HtmlElement Root;
-};
+    //! Elements that are open, the innermost one last.
+    // Children are only ever added to the innermost one, so these never get invalidated.
+    std::vector<HtmlElement*> m_open;
+
+    //! Builds into @c strings, which must not be used by another builder at the same time.
+    HtmlBuilder(std::string_view rootName, std::shared_ptr<StringArena> strings);
 
+    //! Children made away from the tree, along with the strings they point to.
+    struct Shard
+    {
+        StringArena              Strings;
+        std::vector<HtmlElement> Elements;
+    };
+
+    HtmlElement& Current() { return m_open.empty() ? Root : *m_open.back(); }
+
+    //! Makes room for @c count more children, without giving up on growing geometrically.
+    static void Reserve(std::vector<HtmlElement>& elements, std::size_t count);
+    //! Moves the children of @c shards to the element currently open, in order.
+    void Merge(std::vector<Shard>& shards);
+};
 
 #endif    // DESIGN_PATTERNS_HTML_BUILDER_H
@@ -25,12 +25,17 @@
 #ifndef DESIGN_PATTERNS_HTML_ELEMENT_H
 #define DESIGN_PATTERNS_HTML_ELEMENT_H
 
-#include <sstream>
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <vector>
 
+class ConcurrentHtmlBuilder;
 class HtmlBuilder;
+class StringArena;
 
 /**
  * This structure represents a simple HTML element.
@@ -40,34 +45,121 @@ class HtmlElement
 public:
     [[nodiscard]] std::string ToStr(int indent = 0) const
     {
-        std::ostringstream oss;
-        std::string        i(IndentSize * indent, ' ');
-        oss << i << "<" << Name << ">" << std::endl;
+        std::string out;
+        RenderTo(out, indent);
+        return out;
+    }
+
+    /**
+     * Computes the exact number of characters that rendering the element will produce.
+     */
+    [[nodiscard]] std::size_t RenderedSize(int indent = 0) const
+    {
+        const std::size_t width = IndentSize * static_cast<std::size_t>(indent);
+        // "<name>\n" and "</name>\n", both indented.
+        std::size_t size = 2 * width + 2 * Name.size() + 7;
         if (!Text.empty())
         {
-            oss << std::string(IndentSize * (indent + 1), ' ') << Text << std::endl;
+            size += width + IndentSize + Text.size() + 1;
         }
 
         for (const auto& e : Elements)
         {
-            oss << e.ToStr(indent + 1);
+            size += e.RenderedSize(indent + 1);
         }
+        return size;
+    }
 
-        oss << i << "</" << Name << ">" << std::endl;
+    /**
+     * Renders the element at the end of @c out, growing it only once.
+     */
+    void RenderTo(std::string& out, int indent = 0) const
+    {
+        const std::size_t offset = out.size();
+        out.resize(offset + RenderedSize(indent));
+        RenderTo(out.data() + offset, indent);
+    }
 
-        return oss.str();
+    /**
+     * Renders the element through an output iterator, one character at a time.
+     *
+     * @returns The iterator past the last character written.
+     */
+    template<std::output_iterator<char> Out>
+    Out RenderTo(Out out, int indent = 0) const
+    {
+        const std::size_t width = IndentSize * static_cast<std::size_t>(indent);
+
+        out    = std::fill_n(std::move(out), width, ' ');
+        *out++ = '<';
+        out    = std::ranges::copy(Name, std::move(out)).out;
+        *out++ = '>';
+        *out++ = '\n';
+        if (!Text.empty())
+        {
+            out    = std::fill_n(std::move(out), width + IndentSize, ' ');
+            out    = std::ranges::copy(Text, std::move(out)).out;
+            *out++ = '\n';
+        }
+
+        for (const auto& e : Elements)
+        {
+            out = e.RenderTo(std::move(out), indent + 1);
+        }
+
+        out    = std::fill_n(std::move(out), width, ' ');
+        *out++ = '<';
+        *out++ = '/';
+        out    = std::ranges::copy(Name, std::move(out)).out;
+        *out++ = '>';
+        *out++ = '\n';
+        return out;
     }
 
     // This function hints to the user that they should use the builder instead of this directly.
     static HtmlBuilder Create(std::string_view name);
 
+#ifdef BASIC_BUILDER_COUNT_COPIES
+    //! Number of times an element has been deep-copied, used to benchmark the builder.
+    static inline std::size_t CopyCount = 0;
+#endif
+
+    HtmlElement(const HtmlElement& o)
+    : Name(o.Name), Text(o.Text), Elements(o.Elements), Strings(o.Strings)
+    {
+#ifdef BASIC_BUILDER_COUNT_COPIES
+        ++CopyCount;
+#endif
+    }
+    HtmlElement(HtmlElement&&) noexcept = default;
+    HtmlElement& operator=(const HtmlElement& o)
+    {
+        if (this != &o)
+        {
+#ifdef BASIC_BUILDER_COUNT_COPIES
+            ++CopyCount;
+#endif
+            Name     = o.Name;
+            Text     = o.Text;
+            Elements = o.Elements;
+            Strings  = o.Strings;
+        }
+        return *this;
+    }
+    HtmlElement& operator=(HtmlElement&&) noexcept = default;
+    ~HtmlElement()                                 = default;
+
 private:
+    friend class ConcurrentHtmlBuilder;
     friend class HtmlBuilder;
     std::string_view Name;
     std::string_view Text;
 
     std::vector<HtmlElement> Elements;
 
+    //! Storage of the names and texts of the element and its children, set on built roots only.
+    std::shared_ptr<StringArena> Strings;
+
     static constexpr const size_t IndentSize = 2;
 
     HtmlElement() = default;
@@ -0,0 +1,90 @@
+/**
+ * @file    string_arena.cpp
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+#include "string_arena.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+
+std::string_view StringArena::Store(std::string_view str)
+{
+    if (str.empty())
+    {
+        return {};
+    }
+
+    if (str.size() > m_remaining)
+    {
+        // Each chunk is twice as large as the previous one, so that a document only ever needs a
+        // handful of them.
+        const std::size_t size = std::max(m_nextChunkSize, str.size());
+        m_chunks.push_back(std::make_unique_for_overwrite<char[]>(size));
+        m_cursor        = m_chunks.back().get();
+        m_remaining     = size;
+        m_nextChunkSize = 2 * size;
+    }
+
+    std::memcpy(m_cursor, str.data(), str.size());
+    const std::string_view stored {m_cursor, str.size()};
+    m_cursor += str.size();
+    m_remaining -= str.size();
+    m_bytesUsed += str.size();
+    return stored;
+}
+
+std::string_view StringArena::Intern(std::string_view str)
+{
+    if (const auto it = m_interned.find(str); it != m_interned.end())
+    {
+        return *it;
+    }
+    const std::string_view stored = Store(str);
+    m_interned.insert(stored);
+    return stored;
+}
+
+void StringArena::Adopt(StringArena&& other)
+{
+    if (&other == this)
+    {
+        return;
+    }
+
+    // Only the chunks move, not their content. The current chunk stays the one being filled.
+    m_chunks.insert(m_chunks.end(),
+                    std::make_move_iterator(other.m_chunks.begin()),
+                    std::make_move_iterator(other.m_chunks.end()));
+    m_interned.merge(other.m_interned);
+    m_kept.insert(m_kept.end(),
+                  std::make_move_iterator(other.m_kept.begin()),
+                  std::make_move_iterator(other.m_kept.end()));
+    m_bytesUsed += other.m_bytesUsed;
+
+    other.m_chunks.clear();
+    other.m_interned.clear();
+    other.m_kept.clear();
+    other.m_cursor    = nullptr;
+    other.m_remaining = 0;
+    other.m_bytesUsed = 0;
+}
@@ -0,0 +1,88 @@
+/**
+ * @file    string_arena.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_STRING_ARENA_H
+#define DESIGN_PATTERNS_STRING_ARENA_H
+
+#include <cstddef>
+#include <memory>
+#include <string_view>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+/**
+ * Owns copies of strings, packed together in a few large chunks.
+ *
+ * The views handed out stay valid for as long as the arena lives, even if it is moved.
+ */
+class StringArena
+{
+public:
+    static constexpr std::size_t DefaultChunkSize = 4096;
+
+    explicit StringArena(std::size_t chunkSize = DefaultChunkSize) : m_nextChunkSize(chunkSize) {}
+
+    StringArena(const StringArena&)            = delete;
+    StringArena& operator=(const StringArena&) = delete;
+    StringArena(StringArena&&) noexcept        = default;
+    StringArena& operator=(StringArena&&)      = default;
+    ~StringArena()                             = default;
+
+    //! Copies @c str into the arena.
+    std::string_view Store(std::string_view str);
+
+    //! Copies @c str into the arena, unless an equal string was already interned.
+    std::string_view Intern(std::string_view str);
+
+    /**
+     * Takes over the strings of @c other, leaving it empty.
+     *
+     * The strings stay where they are, so the views that @c other handed out remain valid for as
+     * long as this arena lives.
+     */
+    void Adopt(StringArena&& other);
+
+    //! Keeps @c other alive for as long as this arena lives, for strings that can't be taken over.
+    void KeepAlive(std::shared_ptr<const StringArena> other)
+    {
+        m_kept.push_back(std::move(other));
+    }
+
+    [[nodiscard]] std::size_t ChunkCount() const { return m_chunks.size(); }
+    //! Number of characters stored, interned strings counting only once.
+    [[nodiscard]] std::size_t BytesUsed() const { return m_bytesUsed; }
+
+private:
+    std::vector<std::unique_ptr<char[]>> m_chunks;
+    char*                                m_cursor        = nullptr;
+    std::size_t                          m_remaining     = 0;
+    std::size_t                          m_nextChunkSize = DefaultChunkSize;
+    std::size_t                          m_bytesUsed     = 0;
+    std::unordered_set<std::string_view> m_interned;
+
+    std::vector<std::shared_ptr<const StringArena>> m_kept;
+};
+
+#endif    // DESIGN_PATTERNS_STRING_ARENA_H
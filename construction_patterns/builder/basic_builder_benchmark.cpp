@@ -0,0 +1,425 @@
+/**
+ * @file    basic_builder_benchmark.cpp
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * This program measures the cost of building and rendering documents with the basic builder.
+ *
+ * It is built with BASIC_BUILDER_COUNT_COPIES defined, so that deep copies of elements are counted.
+ */
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <iostream>
+#include <iterator>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <thread>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "basic_builder/concurrent_html_builder.h"
+#include "basic_builder/html_builder.h"
+
+namespace
+{
+std::atomic<std::size_t> g_allocations = 0;
+}    // namespace
+
+// Every allocation of the program is counted, to see how many the builder needs.
+void* operator new(std::size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size))
+    {
+        return p;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t /*size*/) noexcept
+{
+    std::free(p);
+}
+
+namespace
+{
+template<typename Func>
+double MeasureMs(Func&& func, int iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        func();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+// A chain of elements, each one nested in the previous one.
+HtmlElement BuildDeep(int depth)
+{
+    using namespace std::string_view_literals;
+
+    HtmlBuilder builder = HtmlElement::Create("div"sv).AddChild("p"sv, "Some text"sv);
+    if (depth > 1)
+    {
+        builder.AddChild(BuildDeep(depth - 1));
+    }
+    return std::move(builder).Build();
+}
+
+// A single list with many items.
+HtmlElement BuildWide(int width)
+{
+    using namespace std::string_view_literals;
+
+    HtmlBuilder builder = HtmlElement::Create("ul"sv);
+    for (int i = 0; i < width; ++i)
+    {
+        builder.AddChild("li"sv, "Some list item"sv);
+    }
+    return std::move(builder).Build();
+}
+
+void BenchmarkConstruction()
+{
+    using namespace std::string_view_literals;
+
+    static constexpr int Sections   = 1000;
+    static constexpr int Items      = 99;
+    static constexpr int Iterations = 10;
+
+    std::cout << "Building a document of " << Sections << " lists of " << Items << " items:\n";
+
+    // Each list is built on its own, then copied into the document.
+    HtmlElement::CopyCount = 0;
+    const double copiedMs  = MeasureMs(
+      []
+      {
+          HtmlBuilder body = HtmlElement::Create("body"sv);
+          for (int i = 0; i < Sections; ++i)
+          {
+              HtmlBuilder list = HtmlElement::Create("ul"sv);
+              for (int j = 0; j < Items; ++j)
+              {
+                  list.AddChild("li"sv, "Some list item"sv);
+              }
+              body.AddChild(list.Build());
+          }
+          return body.Build();
+      },
+      Iterations);
+    const auto copiedCnt = HtmlElement::CopyCount / Iterations;
+
+    HtmlElement::CopyCount = 0;
+    const double scopedMs  = MeasureMs(
+      []
+      {
+          HtmlBuilder body = HtmlElement::Create("body"sv);
+          for (int i = 0; i < Sections; ++i)
+          {
+              body.Open("ul"sv);
+              for (int j = 0; j < Items; ++j)
+              {
+                  body.AddChild("li"sv, "Some list item"sv);
+              }
+              body.Close();
+          }
+          return std::move(body).Build();
+      },
+      Iterations);
+    const auto scopedCnt = HtmlElement::CopyCount / Iterations;
+
+    HtmlElement::CopyCount = 0;
+    const double lambdaMs  = MeasureMs(
+      []
+      {
+          HtmlBuilder body = HtmlElement::Create("body"sv);
+          for (int i = 0; i < Sections; ++i)
+          {
+              body.AddChild("ul"sv,
+                            [](HtmlBuilder& list)
+                            {
+                                for (int j = 0; j < Items; ++j)
+                                {
+                                    list.AddChild("li"sv, "Some list item"sv);
+                                }
+                            });
+          }
+          return std::move(body).Build();
+      },
+      Iterations);
+    const auto lambdaCnt = HtmlElement::CopyCount / Iterations;
+
+    std::cout << "  copied children: " << copiedMs << " ms, " << copiedCnt << " copies\n"
+              << "  open and close:  " << scopedMs << " ms, " << scopedCnt << " copies\n"
+              << "  lambdas:         " << lambdaMs << " ms, " << lambdaCnt << " copies\n";
+}
+
+void BenchmarkRuntimeStrings()
+{
+    using namespace std::string_view_literals;
+
+    static constexpr int Items = 100000;
+
+    std::cout << "Building a list of " << Items << " items whose text is only known at runtime:\n";
+
+    // Without the arena, the strings had to be kept alive on the side of the tree. Both sides
+    // build the same list, so that only the handling of the strings differs.
+    std::size_t             allocations = g_allocations;
+    std::deque<std::string> texts;
+    HtmlBuilder             kept   = HtmlElement::Create("ul"sv);
+    const double            keptMs = MeasureMs(
+      [&]
+      {
+          for (int i = 0; i < Items; ++i)
+          {
+              texts.push_back("Some list item number " + std::to_string(i));
+              kept.AddChild("li"sv, texts.back());
+          }
+      },
+      1);
+    const std::size_t keptAllocations = g_allocations - allocations;
+
+    allocations = g_allocations;
+    std::string  text;
+    HtmlBuilder  builder = HtmlElement::Create("ul"sv);
+    const double arenaMs = MeasureMs(
+      [&]
+      {
+          for (int i = 0; i < Items; ++i)
+          {
+              text = "Some list item number ";
+              text += std::to_string(i);
+              builder.AddChild("li"sv, text);
+          }
+      },
+      1);
+    const std::size_t arenaAllocations = g_allocations - allocations;
+
+    std::cout << "  side std::deque<std::string>: " << keptMs << " ms, " << keptAllocations
+              << " allocations for the whole list\n"
+              << "  string arena:                 " << arenaMs << " ms, " << arenaAllocations
+              << " allocations for the whole list, " << builder.Strings().ChunkCount()
+              << " of them for the strings\n";
+}
+
+void BenchmarkBulkChildren()
+{
+    using namespace std::string_view_literals;
+
+    static constexpr int Rows       = 2000000;
+    static constexpr int Iterations = 5;
+
+    // Stands for the result of a query, of which each row becomes an item.
+    struct Row
+    {
+        int         Id;
+        std::string Name;
+    };
+    std::vector<Row> rows;
+    rows.reserve(Rows);
+    for (int i = 0; i < Rows; ++i)
+    {
+        rows.push_back({i, "Customer #" + std::to_string(i)});
+    }
+
+    std::cout << "Building a list of " << Rows << " items from the rows of a query:\n";
+
+    std::size_t  allocations = g_allocations;
+    const double oneByOneMs  = MeasureMs(
+      [&]
+      {
+          HtmlBuilder builder = HtmlElement::Create("ul"sv);
+          for (const auto& row : rows)
+          {
+              builder.AddChild("li"sv, row.Name);
+          }
+          return std::move(builder).Build();
+      },
+      Iterations);
+    const std::size_t oneByOneAllocations = (g_allocations - allocations) / Iterations;
+
+    allocations         = g_allocations;
+    const double bulkMs = MeasureMs(
+      [&]
+      {
+          return HtmlElement::Create("ul"sv).AddChildren("li"sv, rows, &Row::Name).Build();
+      },
+      Iterations);
+    const std::size_t bulkAllocations = (g_allocations - allocations) / Iterations;
+
+    const ParallelFill fill;
+    allocations             = g_allocations;
+    const double parallelMs = MeasureMs(
+      [&]
+      {
+          return HtmlElement::Create("ul"sv).AddChildren(fill, "li"sv, rows, &Row::Name).Build();
+      },
+      Iterations);
+    const std::size_t parallelAllocations = (g_allocations - allocations) / Iterations;
+
+    std::cout << "  AddChild:    " << oneByOneMs << " ms, " << oneByOneAllocations
+              << " allocations\n"
+              << "  AddChildren: " << bulkMs << " ms, " << bulkAllocations << " allocations\n"
+              << "  AddChildren: " << parallelMs << " ms, " << parallelAllocations
+              << " allocations, on " << fill.Threads << " thread(s)\n";
+}
+
+void BenchmarkConcurrentBuilding()
+{
+    using namespace std::string_view_literals;
+
+    static constexpr int Workers    = 4;
+    static constexpr int Sections   = 250;
+    static constexpr int Items      = 400;
+    static constexpr int Iterations = 5;
+
+    std::cout << "Building a report of " << Workers << " parts of " << Sections << " sections of "
+              << Items << " items, each part on its own thread:\n";
+
+    const auto runWorkers = [](auto&& work)
+    {
+        std::vector<std::jthread> threads;
+        for (int w = 0; w < Workers; ++w)
+        {
+            threads.emplace_back(work, w);
+        }
+    };
+
+    // Every addition goes through the same lock, and the parts end up interleaved.
+    const double lockedMs = MeasureMs(
+      [&]
+      {
+          std::mutex  mutex;
+          HtmlBuilder report = HtmlElement::Create("body"sv);
+          runWorkers(
+            [&](int worker)
+            {
+                for (int i = 0; i < Sections; ++i)
+                {
+                    const std::string title = "Section " + std::to_string(worker * Sections + i);
+                    std::scoped_lock  lock {mutex};
+                    report.Open("section"sv, title);
+                    for (int j = 0; j < Items; ++j)
+                    {
+                        report.AddChild("p"sv, "Some paragraph"sv);
+                    }
+                    report.Close();
+                }
+            });
+          return std::move(report).Build();
+      },
+      Iterations);
+
+    double       mergeMs   = 0;
+    const double shardedMs = MeasureMs(
+      [&]
+      {
+          ConcurrentHtmlBuilder report("body"sv, Workers);
+          runWorkers(
+            [&](int worker)
+            {
+                HtmlBuilder& part = report.Shard(worker);
+                for (int i = 0; i < Sections; ++i)
+                {
+                    part.Open("section"sv, "Section " + std::to_string(worker * Sections + i));
+                    for (int j = 0; j < Items; ++j)
+                    {
+                        part.AddChild("p"sv, "Some paragraph"sv);
+                    }
+                    part.Close();
+                }
+            });
+
+          HtmlElement::CopyCount = 0;
+
+          const auto  start = std::chrono::steady_clock::now();
+          HtmlElement body  = std::move(report).Build();
+          mergeMs += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() -
+                                                               start)
+                       .count();
+          return body;
+      },
+      Iterations);
+    const auto mergeCnt = HtmlElement::CopyCount;
+
+    std::cout << "  one builder behind a mutex: " << lockedMs << " ms\n"
+              << "  one shard per thread:       " << shardedMs << " ms, of which "
+              << mergeMs / Iterations << " ms merging, " << mergeCnt << " copies\n";
+}
+
+void BenchmarkRendering(std::string_view name, const HtmlElement& element, int iterations)
+{
+    std::string  out;
+    const double toStrMs = MeasureMs([&] { out = element.ToStr(); }, iterations);
+    const double reuseMs = MeasureMs(
+      [&]
+      {
+          out.clear();
+          element.RenderTo(out);
+      },
+      iterations);
+
+    std::ostringstream stream;
+    const double       streamMs = MeasureMs(
+      [&]
+      {
+          stream.str({});
+          element.RenderTo(std::ostreambuf_iterator<char> {stream});
+      },
+      iterations);
+
+    std::cout << "Rendering a " << name << " document of " << element.RenderedSize()
+              << " characters:\n"
+              << "  ToStr():                 " << toStrMs << " ms\n"
+              << "  RenderTo(std::string&):  " << reuseMs << " ms, buffer reused\n"
+              << "  RenderTo(iterator):      " << streamMs << " ms, into a std::ostringstream\n";
+}
+}    // namespace
+
+int main()
+{
+    static constexpr int Depth      = 1000;
+    static constexpr int Width      = 100000;
+    static constexpr int Iterations = 20;
+
+    BenchmarkConstruction();
+    BenchmarkRuntimeStrings();
+    BenchmarkBulkChildren();
+    BenchmarkConcurrentBuilding();
+    BenchmarkRendering("deep", BuildDeep(Depth), Iterations);
+    BenchmarkRendering("wide", BuildWide(Width), Iterations);
+    return 0;
+}
@@ -29,7 +29,16 @@
 
 struct Body : Tag
 {
-    Body(std::initializer_list<Tag> children) : Tag("body", children) {}
+    template<typename... Tags>
+        requires ChildTagsOf<Body, Tags...>
+    Body(Tags&&... children) : Tag(TagId::Body, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    template<typename View>
+        requires ChildTagView<View>
+    Body(View&& children) : Tag(TagId::Body, std::forward<View>(children))
+    {
+    }
 };
 
 #endif    // DESIGN_PATTERNS_BODY_H
@@ -29,6 +29,6 @@
 
 struct Br : Tag
 {
-    Br() : Tag("br", "") {}
+    Br() : Tag(TagId::Br, "") {}
 };
 #endif    // DESIGN_PATTERNS_BR_H
@@ -29,31 +29,31 @@
 
 struct H1 : Tag
 {
-    H1(std::string text) : Tag("h1", text) {}
+    H1(std::string_view text) : Tag(TagId::H1, text) {}
 };
 
 struct H2 : Tag
 {
-    H2(std::string text) : Tag("h2", text) {}
+    H2(std::string_view text) : Tag(TagId::H2, text) {}
 };
 
 struct H3 : Tag
 {
-    H3(std::string text) : Tag("h3", text) {}
+    H3(std::string_view text) : Tag(TagId::H3, text) {}
 };
 
 struct H4 : Tag
 {
-    H4(std::string text) : Tag("h4", text) {}
+    H4(std::string_view text) : Tag(TagId::H4, text) {}
 };
 
 struct H5 : Tag
 {
-    H5(std::string text) : Tag("h5", text) {}
+    H5(std::string_view text) : Tag(TagId::H5, text) {}
 };
 
 struct H6 : Tag
 {
-    H6(std::string text) : Tag("h6", text) {}
+    H6(std::string_view text) : Tag(TagId::H6, text) {}
 };
 #endif    // DESIGN_PATTERNS_H_H
@@ -28,6 +28,15 @@
 
 struct Head : Tag
 {
-    Head(std::initializer_list<Tag> children) : Tag("head", children) {}
+    template<typename... Tags>
+        requires ChildTagsOf<Head, Tags...>
+    Head(Tags&&... children) : Tag(TagId::Head, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    template<typename View>
+        requires ChildTagView<View>
+    Head(View&& children) : Tag(TagId::Head, std::forward<View>(children))
+    {
+    }
 };
 #endif    // DESIGN_PATTERNS_HEAD_H
@@ -30,6 +30,6 @@
 
 struct Hr : Tag
 {
-    Hr() : Tag("hr", "") {}
+    Hr() : Tag(TagId::Hr, "") {}
 };
 #endif    // DESIGN_PATTERNS_HR_H
@@ -27,21 +27,39 @@
 
 #include "../tag.h"
 
-#include <initializer_list>
+#include <utility>
+#include <memory_resource>
+#include <vector>
 
 struct Html : Tag
 {
-    Html(std::initializer_list<Tag> children, std::initializer_list<Tag::Attribute> attributes = {} )
-    : Tag("html", children)
+    template<typename... Tags>
+        requires ChildTagsOf<Html, Tags...>
+    Html(Tags&&... children) : Tag(TagId::Html, MakeChildren(std::forward<Tags>(children)...))
+    {
+        // The lang tag should always be included.
+        Attributes.emplace_back(AttributeId::Lang, "en");
+    }
+
+    template<typename View>
+        requires ChildTagView<View>
+    Html(View&& children) : Tag(TagId::Html, std::forward<View>(children))
+    {
+        // The lang tag should always be included.
+        Attributes.emplace_back(AttributeId::Lang, "en");
+    }
+
+    Html(std::pmr::vector<Tag> children, std::pmr::vector<Tag::Attribute> attributes)
+    : Tag(TagId::Html, std::move(children))
     {
         if (empty(attributes))
         {
             // The lang tag should always be included.
-            Attributes.emplace_back("lang", "en");
+            Attributes.emplace_back(AttributeId::Lang, "en");
         }
         else
         {
-            Attributes = attributes;
+            Attributes = std::move(attributes);
         }
     }
 };
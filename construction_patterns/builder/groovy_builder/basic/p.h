@@ -27,12 +27,21 @@
 
 #include "../tag.h"
 
-#include <initializer_list>
+#include <utility>
 
 struct P : Tag
 {
-    P(std::string text) : Tag("p", text) {}
-    P(std::initializer_list<Tag> children) : Tag("p", children) {}
+    P(std::string_view text) : Tag(TagId::P, text) {}
+    template<typename... Tags>
+        requires ChildTagsOf<P, Tags...>
+    P(Tags&&... children) : Tag(TagId::P, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    template<typename View>
+        requires ChildTagView<View>
+    P(View&& children) : Tag(TagId::P, std::forward<View>(children))
+    {
+    }
 };
 
 #endif    // DESIGN_PATTERNS_P_H
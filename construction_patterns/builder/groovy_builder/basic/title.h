@@ -29,6 +29,6 @@
 
 struct Title : Tag
 {
-    Title(std::string t) : Tag("title", t) {}
+    Title(std::string_view t) : Tag(TagId::Title, t) {}
 };
 #endif    // DESIGN_PATTERNS_TITLE_H
@@ -0,0 +1,232 @@
+/**
+ * @file    binary_document.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Binary, memory-mappable format for flat documents.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_BINARY_DOCUMENT_H
+#define DESIGN_PATTERNS_BINARY_DOCUMENT_H
+
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "flat_document.h"
+#include "mapped_file.h"
+#include "stream_renderer.h"
+
+/**
+ * Location of one of the tables of a binary document.
+ */
+struct BinarySection
+{
+    //! Offset of the table from the start of the file.
+    std::uint64_t Offset = 0;
+    //! Number of elements in the table.
+    std::uint64_t Count = 0;
+};
+
+/**
+ * Header found at the start of a binary document.
+ *
+ * The header is followed by the tables of a flat document: nodes, attributes, names and strings,
+ * each starting on a multiple of @c SectionAlignment. Since nodes only refer to each other by
+ * index, the tables are used in place, as they are, wherever the file is mapped.
+ *
+ * The tables are written in the byte order of the machine, files are not meant to be shared
+ * between machines that disagree on it.
+ */
+struct BinaryDocumentHeader
+{
+    static constexpr std::array<char, 8> ExpectedMagic     = {'G', 'R', 'O', 'O', 'V', 'Y', 'D', 'C'};
+    static constexpr std::uint32_t       CurrentVersion    = 1;
+    static constexpr std::uint32_t       ExpectedByteOrder = 0x01020304;
+    static constexpr std::size_t         SectionAlignment  = 8;
+
+    std::array<char, 8> Magic     = ExpectedMagic;
+    std::uint32_t       Version   = CurrentVersion;
+    std::uint32_t       ByteOrder = ExpectedByteOrder;
+    BinarySection       Nodes;
+    BinarySection       Attributes;
+    BinarySection       Names;
+    BinarySection       Strings;
+};
+
+static_assert(std::is_trivially_copyable_v<BinaryDocumentHeader>);
+static_assert(std::is_trivially_copyable_v<FlatNode>);
+static_assert(std::is_trivially_copyable_v<FlatAttribute>);
+static_assert(std::is_trivially_copyable_v<FlatString>);
+
+/**
+ * Writes a flat document to @c sink in the binary format.
+ *
+ * @tparam Sink See stream_renderer.h
+ */
+template<typename Sink>
+void WriteBinaryDocument(const FlatView& document, Sink&& sink)
+{
+    static constexpr std::array<char, BinaryDocumentHeader::SectionAlignment> padding {};
+
+    BinaryDocumentHeader header;
+    std::uint64_t        offset = 0;
+    const auto           place  = [&offset](BinarySection& section, std::size_t count, std::size_t size)
+    {
+        offset = (offset + BinaryDocumentHeader::SectionAlignment - 1) /
+                 BinaryDocumentHeader::SectionAlignment * BinaryDocumentHeader::SectionAlignment;
+        section = {offset, count};
+        offset += count * size;
+    };
+    offset = sizeof(BinaryDocumentHeader);
+    place(header.Nodes, document.Nodes.size(), sizeof(FlatNode));
+    place(header.Attributes, document.Attributes.size(), sizeof(FlatAttribute));
+    place(header.Names, document.Names.size(), sizeof(FlatString));
+    place(header.Strings, document.Strings.size(), sizeof(char));
+
+    std::uint64_t written = 0;
+    const auto    write   = [&](const void* data, std::size_t size)
+    {
+        sink(std::string_view {static_cast<const char*>(data), size});
+        written += size;
+    };
+    const auto writeSection = [&](const BinarySection& section, const void* data, std::size_t size)
+    {
+        write(padding.data(), section.Offset - written);
+        write(data, size);
+    };
+
+    write(&header, sizeof(header));
+    writeSection(header.Nodes, document.Nodes.data(), document.Nodes.size_bytes());
+    writeSection(header.Attributes, document.Attributes.data(), document.Attributes.size_bytes());
+    writeSection(header.Names, document.Names.data(), document.Names.size_bytes());
+    writeSection(header.Strings, document.Strings.data(), document.Strings.size());
+}
+
+/**
+ * Writes a flat document to the file at @c path in the binary format, replacing it if it exists.
+ *
+ * @throws std::system_error if the file cannot be written.
+ */
+inline void SaveBinaryDocument(const FlatView& document, const std::string& path)
+{
+    const int fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0)
+    {
+        throw std::system_error(errno, std::generic_category(), "Unable to create " + path);
+    }
+
+    try
+    {
+        WriteBinaryDocument(document, FdSink {fd});
+    }
+    catch (...)
+    {
+        ::close(fd);
+        throw;
+    }
+    ::close(fd);
+}
+
+/**
+ * A flat document used straight from a mapped binary file.
+ *
+ * Loading only reads the header: the tables are paged in by the kernel as they are walked, which
+ * is what rendering the document or materializing some of its nodes with ToTag() does.
+ *
+ * Only the layout of the file is checked, not the indices stored in its tables. Files are expected
+ * to come from SaveBinaryDocument().
+ */
+class BinaryDocument
+{
+public:
+    /**
+     * @throws std::system_error if the file cannot be mapped.
+     * @throws std::runtime_error if the file is not a binary document this version can use.
+     */
+    explicit BinaryDocument(const std::string& path) : m_file(path), m_view(Map(m_file, path)) {}
+
+    [[nodiscard]] const FlatView& View() const noexcept { return m_view; }
+
+    [[nodiscard]] std::size_t NodeCount() const noexcept { return m_view.Nodes.size(); }
+
+    [[nodiscard]] std::string Render(std::size_t indent = 0) const { return m_view.Render(indent); }
+
+    void RenderTo(std::string& out, std::size_t indent = 0) const { m_view.RenderTo(out, indent); }
+
+    [[nodiscard]] Tag ToTag(std::uint32_t index = 0) const { return m_view.ToTag(index); }
+
+private:
+    MappedFile m_file;
+    FlatView   m_view;
+
+    static FlatView Map(const MappedFile& file, const std::string& path)
+    {
+        BinaryDocumentHeader header;
+        if (file.size() < sizeof(header))
+        {
+            throw std::runtime_error(path + " is too small to be a binary document");
+        }
+        std::memcpy(&header, file.data(), sizeof(header));
+
+        if (header.Magic != BinaryDocumentHeader::ExpectedMagic)
+        {
+            throw std::runtime_error(path + " is not a binary document");
+        }
+        if (header.Version != BinaryDocumentHeader::CurrentVersion ||
+            header.ByteOrder != BinaryDocumentHeader::ExpectedByteOrder)
+        {
+            throw std::runtime_error(path + " was written by an incompatible version or machine");
+        }
+
+        const auto strings = Section<char>(file, header.Strings, path);
+        return {Section<FlatNode>(file, header.Nodes, path),
+                Section<FlatAttribute>(file, header.Attributes, path),
+                Section<FlatString>(file, header.Names, path),
+                {strings.data(), strings.size()}};
+    }
+
+    template<typename T>
+    static std::span<const T> Section(const MappedFile& file,
+                                      const BinarySection& section,
+                                      const std::string&   path)
+    {
+        if (section.Offset % alignof(T) != 0 || section.Offset > file.size() ||
+            section.Count > (file.size() - section.Offset) / sizeof(T))
+        {
+            throw std::runtime_error(path + " is truncated or corrupted");
+        }
+        return {reinterpret_cast<const T*>(static_cast<const char*>(file.data()) + section.Offset),
+                static_cast<std::size_t>(section.Count)};
+    }
+};
+
+#endif    // DESIGN_PATTERNS_BINARY_DOCUMENT_H
@@ -0,0 +1,197 @@
+/**
+ * @file    child_generator.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Children of a tag produced on demand from a range.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_CHILD_GENERATOR_H
+#define DESIGN_PATTERNS_CHILD_GENERATOR_H
+
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <ranges>
+#include <type_traits>
+#include <utility>
+
+struct Tag;
+
+/**
+ * A view whose elements are tags, and that can be walked as many times as needed.
+ *
+ * Walking the view must not modify it, which rules out views that cache their begin, such as
+ * std::views::filter. Containers must be turned into views explicitly, with std::views::all.
+ */
+template<typename Range>
+concept ChildTagView =
+  std::ranges::view<std::remove_cvref_t<Range>> &&
+  std::ranges::forward_range<const std::remove_cvref_t<Range>> &&
+  std::derived_from<std::remove_cvref_t<std::ranges::range_reference_t<const std::remove_cvref_t<Range>>>,
+                    Tag>;
+
+namespace Detail
+{
+/**
+ * Non-owning reference to a callable, cheap to pass through a virtual call.
+ */
+template<typename Signature>
+class FunctionRef;
+
+template<typename Result, typename... Args>
+class FunctionRef<Result(Args...)>
+{
+public:
+    template<typename Func>
+        requires(!std::same_as<std::remove_cvref_t<Func>, FunctionRef> &&
+                 std::is_invocable_r_v<Result, Func&, Args...>)
+    FunctionRef(Func&& func) noexcept
+    : m_object(const_cast<void*>(static_cast<const void*>(std::addressof(func)))),
+      m_call([](void* object, Args... args) -> Result
+             { return std::invoke(*static_cast<std::remove_reference_t<Func>*>(object), std::forward<Args>(args)...); })
+    {
+    }
+
+    Result operator()(Args... args) const { return m_call(m_object, std::forward<Args>(args)...); }
+
+private:
+    void* m_object;
+    Result (*m_call)(void*, Args...);
+};
+
+/**
+ * Walks generated children one step at a time, for those who can't hand a callback to ForEach().
+ */
+class ChildCursor
+{
+public:
+    virtual ~ChildCursor() = default;
+
+    /**
+     * Moves on to the next child.
+     *
+     * @returns The child, valid until the next call, or nullptr once there are no more.
+     */
+    virtual const Tag* Next() = 0;
+};
+
+/**
+ * Produces the children of a tag one at a time, each one living only for the duration of the call
+ * it is handed to.
+ */
+class ChildGenerator
+{
+public:
+    virtual ~ChildGenerator() = default;
+
+    /**
+     * Number of references to generators taken on this thread, which lets TagArena tell whether a
+     * document it built refers to any.
+     */
+    static std::size_t& SharedOnThisThread()
+    {
+        thread_local std::size_t shared = 0;
+        return shared;
+    }
+
+    [[nodiscard]] virtual bool Empty() const = 0;
+
+    virtual void ForEach(FunctionRef<void(const Tag&)> func) const = 0;
+
+    [[nodiscard]] virtual std::unique_ptr<ChildCursor> Walk() const = 0;
+};
+
+template<typename View>
+class ViewChildGenerator final : public ChildGenerator
+{
+public:
+    explicit ViewChildGenerator(View view) : m_view(std::move(view)) {}
+
+    [[nodiscard]] bool Empty() const override
+    {
+        return std::ranges::begin(m_view) == std::ranges::end(m_view);
+    }
+
+    void ForEach(FunctionRef<void(const Tag&)> func) const override
+    {
+        for (auto&& child : m_view)
+        {
+            func(child);
+        }
+    }
+
+    [[nodiscard]] std::unique_ptr<ChildCursor> Walk() const override
+    {
+        return std::make_unique<Cursor>(m_view);
+    }
+
+private:
+    View m_view;
+
+    class Cursor final : public ChildCursor
+    {
+    public:
+        explicit Cursor(const View& view)
+        : m_it(std::ranges::begin(view)), m_end(std::ranges::end(view))
+        {
+        }
+
+        const Tag* Next() override
+        {
+            if (m_it == m_end)
+            {
+                return nullptr;
+            }
+
+            // Children that are made on the fly are kept until the next call, those that live in
+            // the view are referred to.
+            const Tag* child = nullptr;
+            if constexpr (std::is_lvalue_reference_v<std::ranges::range_reference_t<const View>>)
+            {
+                child = &static_cast<const Tag&>(*m_it);
+            }
+            else
+            {
+                m_current.emplace(*m_it);
+                child = &*m_current;
+            }
+            ++m_it;
+            return child;
+        }
+
+    private:
+        std::ranges::iterator_t<const View>                   m_it;
+        std::ranges::sentinel_t<const View>                   m_end;
+        std::optional<std::ranges::range_value_t<const View>> m_current;
+    };
+};
+
+template<typename View>
+std::shared_ptr<const ChildGenerator> MakeChildGenerator(View&& view)
+{
+    ++ChildGenerator::SharedOnThisThread();
+    return std::make_shared<const ViewChildGenerator<std::remove_cvref_t<View>>>(std::forward<View>(view));
+}
+}    // namespace Detail
+
+#endif    // DESIGN_PATTERNS_CHILD_GENERATOR_H
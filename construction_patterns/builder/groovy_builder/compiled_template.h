@@ -0,0 +1,506 @@
+/**
+ * @file    compiled_template.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Tag trees compiled into templates with named slots.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_COMPILED_TEMPLATE_H
+#define DESIGN_PATTERNS_COMPILED_TEMPLATE_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <ranges>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+#include "escape.h"
+#include "render.h"
+#include "tag.h"
+
+/**
+ * Creates the placeholder of the slot named @c name, to be used in a text or an attribute value.
+ *
+ * Names are made of letters, digits, '_', '-' and '.'.
+ */
+inline std::string Placeholder(std::string_view name)
+{
+    std::string out;
+    out.reserve(name.size() + 4);
+    out.append("{{").append(name).append("}}");
+    return out;
+}
+
+namespace Detail
+{
+struct PlaceholderRef
+{
+    std::size_t      Begin = 0;
+    std::size_t      End   = 0;
+    std::string_view Name;
+};
+
+constexpr bool IsSlotNameChar(char c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_' ||
+           c == '-' || c == '.';
+}
+
+/**
+ * Finds the first placeholder at or after @c from.
+ *
+ * @returns A placeholder starting at the size of @c str if there is none.
+ */
+constexpr PlaceholderRef FindPlaceholder(std::string_view str, std::size_t from)
+{
+    while (true)
+    {
+        const std::size_t open = str.find("{{", from);
+        if (open == std::string_view::npos)
+        {
+            return {str.size(), str.size(), {}};
+        }
+
+        std::size_t end = open + 2;
+        while (end < str.size() && IsSlotNameChar(str[end]))
+        {
+            ++end;
+        }
+        if (end != open + 2 && str.substr(end, 2) == "}}")
+        {
+            return {open, end + 2, str.substr(open + 2, end - open - 2)};
+        }
+        from = open + 1;
+    }
+}
+}    // namespace Detail
+
+/**
+ * Associates the name of a slot with the way to get its value out of a row.
+ *
+ * @tparam Projection Pointer to a data member, or callable taking the row.
+ */
+template<typename Projection>
+struct SlotBinding
+{
+    std::string_view Name;
+    Projection       Get;
+};
+
+template<typename Projection>
+SlotBinding(const char*, Projection) -> SlotBinding<Projection>;
+
+/**
+ * A projection must give something that can be viewed as a string, and that outlives the call.
+ */
+template<typename Projection, typename Row>
+concept SlotProjection =
+  std::invocable<const Projection&, const Row&> &&
+  std::convertible_to<std::invoke_result_t<const Projection&, const Row&>, std::string_view> &&
+  (std::is_reference_v<std::invoke_result_t<const Projection&, const Row&>> ||
+   !std::same_as<std::remove_cvref_t<std::invoke_result_t<const Projection&, const Row&>>,
+                 std::string>);
+
+template<typename Row, typename... Projections>
+class TemplateBinding;
+
+/**
+ * A Tag tree compiled into literal segments and references to named slots.
+ *
+ * The tree is rendered once, at compilation, with its placeholders (see Placeholder()) marking the
+ * slots. Rendering the template afterward only copies the segments and the escaped values of the
+ * slots, without any tree being built or walked.
+ *
+ * The values of slots appearing in raw text are written as-is, the others are escaped.
+ *
+ * @code
+ * const auto page = CompiledTemplate::Compile(Html {Head {Title {Placeholder("title")}}});
+ * page.Render({"My Page"});
+ * @endcode
+ */
+class CompiledTemplate
+{
+public:
+    static constexpr std::uint32_t NoSlot = UINT32_MAX;
+
+    /**
+     * @throws std::invalid_argument if a slot appears both in raw text and in escaped text.
+     */
+    static CompiledTemplate Compile(const Tag& root, const RenderOptions& options = {})
+    {
+        CompiledTemplate compiled;
+        compiled.FindRawSlots(root);
+        compiled.CheckEscapedSlots(root);
+
+        const std::string rendered = root.Render(options);
+        std::size_t       position = 0;
+        std::size_t       literal  = 0;
+        while (true)
+        {
+            const auto placeholder = Detail::FindPlaceholder(rendered, position);
+            compiled.m_literals.append(rendered, position, placeholder.Begin - position);
+            if (placeholder.Begin == rendered.size())
+            {
+                break;
+            }
+
+            compiled.AddInstruction(literal, compiled.AddSlot(placeholder.Name));
+            literal  = compiled.m_literals.size();
+            position = placeholder.End;
+        }
+        if (literal != compiled.m_literals.size() || compiled.m_program.empty())
+        {
+            compiled.AddInstruction(literal, NoSlot);
+        }
+        return compiled;
+    }
+
+    [[nodiscard]] std::size_t SlotCount() const noexcept { return m_slots.size(); }
+
+    /**
+     * Names of the slots, in the order in which they first appear in the document.
+     */
+    [[nodiscard]] std::vector<std::string_view> SlotNames() const
+    {
+        std::vector<std::string_view> names;
+        names.reserve(m_slots.size());
+        for (const auto& slot : m_slots)
+        {
+            names.push_back(slot.Name);
+        }
+        return names;
+    }
+
+    /**
+     * @throws std::out_of_range if there is no slot by that name.
+     */
+    [[nodiscard]] std::uint32_t SlotIndex(std::string_view name) const
+    {
+        const auto it =
+          std::ranges::find_if(m_slots, [name](const Slot& slot) { return slot.Name == name; });
+        if (it == m_slots.end())
+        {
+            throw std::out_of_range("The template has no slot named " + std::string {name});
+        }
+        return static_cast<std::uint32_t>(it - m_slots.begin());
+    }
+
+    /**
+     * Hands the document to @c writer, with the value of each slot taken from @c values.
+     *
+     * @param values One value per slot, in the order of SlotNames().
+     * @tparam Writer See render.h
+     */
+    template<typename Writer>
+    void Write(Writer& writer, std::span<const std::string_view> values) const
+    {
+        const std::string_view literals = m_literals;
+        for (const auto& instruction : m_program)
+        {
+            writer.Append(literals.substr(instruction.Offset, instruction.Size));
+            if (instruction.Slot == NoSlot)
+            {
+                continue;
+            }
+
+            if (m_slots[instruction.Slot].Raw)
+            {
+                writer.Append(values[instruction.Slot]);
+            }
+            else
+            {
+                WriteEscaped(writer, values[instruction.Slot]);
+            }
+        }
+    }
+
+    /**
+     * Appends the document to @c out, growing it only once.
+     *
+     * @throws std::out_of_range if fewer values than slots are given.
+     */
+    void RenderTo(std::string& out, std::span<const std::string_view> values) const
+    {
+        CheckValueCount(values.size());
+
+        SizeCounter counter;
+        Write(counter, values);
+
+        const std::size_t offset = out.size();
+        out.resize(offset + counter.Size);
+        BufferWriter writer {out.data() + offset};
+        Write(writer, values);
+    }
+
+    /**
+     * Appends the document to @c out, the elements of @c row filling the slots in order.
+     *
+     * @throws std::out_of_range if the row has fewer elements than there are slots.
+     */
+    template<typename... Values>
+        requires(std::convertible_to<const Values&, std::string_view> && ...)
+    void RenderTo(std::string& out, const std::tuple<Values...>& row) const
+    {
+        const auto values = std::apply([](const auto&... value)
+                                       { return std::array<std::string_view, sizeof...(Values)> {value...}; },
+                                       row);
+        RenderTo(out, std::span<const std::string_view> {values});
+    }
+
+    [[nodiscard]] std::string Render(std::span<const std::string_view> values) const
+    {
+        std::string out;
+        RenderTo(out, values);
+        return out;
+    }
+
+    [[nodiscard]] std::string Render(std::initializer_list<std::string_view> values) const
+    {
+        return Render(std::span {values.begin(), values.size()});
+    }
+
+    /**
+     * Binds the slots of the template to the fields of a row type.
+     *
+     * The template must outlive the binding.
+     *
+     * @code
+     * const auto binding = page.Bind<Row>(SlotBinding {"title", &Row::Title});
+     * @endcode
+     *
+     * @throws std::out_of_range if a binding names a slot the template doesn't have.
+     * @throws std::invalid_argument if a slot of the template is left unbound.
+     */
+    template<typename Row, typename... Projections>
+        requires(SlotProjection<Projections, Row> && ...)
+    [[nodiscard]] TemplateBinding<Row, Projections...> Bind(SlotBinding<Projections>... bindings) const
+    {
+        return TemplateBinding<Row, Projections...> {*this, std::move(bindings)...};
+    }
+
+private:
+    struct Slot
+    {
+        std::string Name;
+        bool        Raw = false;
+    };
+
+    //! Writes a literal segment, then the value of a slot, unless it is NoSlot.
+    struct Instruction
+    {
+        std::uint32_t Offset = 0;
+        std::uint32_t Size   = 0;
+        std::uint32_t Slot   = NoSlot;
+    };
+
+    std::string              m_literals;
+    std::vector<Instruction> m_program;
+    std::vector<Slot>        m_slots;
+
+    //! Names of the slots that appear in raw text, found before compiling.
+    std::vector<std::string> m_rawSlots;
+
+    std::uint32_t AddSlot(std::string_view name)
+    {
+        const auto it =
+          std::ranges::find_if(m_slots, [name](const Slot& slot) { return slot.Name == name; });
+        if (it != m_slots.end())
+        {
+            return static_cast<std::uint32_t>(it - m_slots.begin());
+        }
+
+        m_slots.push_back({std::string {name}, IsRawSlot(name)});
+        return static_cast<std::uint32_t>(m_slots.size() - 1);
+    }
+
+    [[nodiscard]] bool IsRawSlot(std::string_view name) const
+    {
+        return std::ranges::find(m_rawSlots, name) != m_rawSlots.end();
+    }
+
+    void AddInstruction(std::size_t literal, std::uint32_t slot)
+    {
+        m_program.push_back({static_cast<std::uint32_t>(literal),
+                             static_cast<std::uint32_t>(m_literals.size() - literal),
+                             slot});
+    }
+
+    void CheckValueCount(std::size_t count) const
+    {
+        if (count < m_slots.size())
+        {
+            throw std::out_of_range("Not enough values to fill the slots of the template");
+        }
+    }
+
+    /**
+     * Calls @c func with the name of every placeholder found in the texts and attribute values of
+     * @c tag and of its descendants, and whether it is in raw text.
+     */
+    template<typename Func>
+    static void ForEachPlaceholder(const Tag& tag, const Func& func)
+    {
+        const auto scan = [&func](std::string_view str, bool raw)
+        {
+            for (auto placeholder = Detail::FindPlaceholder(str, 0); placeholder.Begin != str.size();
+                 placeholder      = Detail::FindPlaceholder(str, placeholder.End))
+            {
+                func(placeholder.Name, raw);
+            }
+        };
+
+        scan(tag.Text, tag.RawText);
+        for (const auto& attribute : tag.Attributes)
+        {
+            scan(attribute.second, false);
+        }
+        tag.ForEachChild([&func](const Tag& child) { ForEachPlaceholder(child, func); });
+    }
+
+    void FindRawSlots(const Tag& root)
+    {
+        ForEachPlaceholder(root,
+                           [this](std::string_view name, bool raw)
+                           {
+                               if (raw && !IsRawSlot(name))
+                               {
+                                   m_rawSlots.emplace_back(name);
+                               }
+                           });
+    }
+
+    void CheckEscapedSlots(const Tag& root) const
+    {
+        ForEachPlaceholder(root,
+                           [this](std::string_view name, bool raw)
+                           {
+                               if (!raw && IsRawSlot(name))
+                               {
+                                   throw std::invalid_argument("Slot " + std::string {name} +
+                                                               " is used in both raw and escaped text");
+                               }
+                           });
+    }
+};
+
+/**
+ * A compiled template whose slots are filled from the fields of rows.
+ *
+ * @tparam Row Type of the rows, usually a struct.
+ * @tparam Projections See SlotBinding.
+ */
+template<typename Row, typename... Projections>
+class TemplateBinding
+{
+public:
+    TemplateBinding(const CompiledTemplate& compiled, SlotBinding<Projections>... bindings)
+    : m_template(compiled),
+      m_projections(std::move(bindings.Get)...),
+      m_fieldOfSlot(compiled.SlotCount(), Unbound)
+    {
+        std::size_t field = 0;
+        ((m_fieldOfSlot[compiled.SlotIndex(bindings.Name)] = field++), ...);
+
+        const auto unbound = std::ranges::find(m_fieldOfSlot, Unbound);
+        if (unbound != m_fieldOfSlot.end())
+        {
+            throw std::invalid_argument(
+              "Slot " + std::string {compiled.SlotNames()[unbound - m_fieldOfSlot.begin()]} +
+              " is not bound");
+        }
+    }
+
+    void RenderTo(std::string& out, const Row& row) const
+    {
+        RenderBatch(out, std::span<const Row> {&row, 1});
+    }
+
+    [[nodiscard]] std::string Render(const Row& row) const
+    {
+        std::string out;
+        RenderTo(out, row);
+        return out;
+    }
+
+    /**
+     * Appends the document rendered for each row, one after the other, to @c out.
+     *
+     * The size of the whole batch is computed first, so that @c out only grows once.
+     */
+    template<std::ranges::forward_range Rows>
+        requires std::convertible_to<std::ranges::range_reference_t<const Rows&>, const Row&>
+    void RenderBatch(std::string& out, const Rows& rows) const
+    {
+        std::vector<std::string_view> values(m_fieldOfSlot.size());
+
+        SizeCounter counter;
+        for (const Row& row : rows)
+        {
+            Fill(values, row);
+            m_template.Write(counter, std::span<const std::string_view> {values});
+        }
+
+        const std::size_t offset = out.size();
+        out.resize(offset + counter.Size);
+        BufferWriter writer {out.data() + offset};
+        for (const Row& row : rows)
+        {
+            Fill(values, row);
+            m_template.Write(writer, std::span<const std::string_view> {values});
+        }
+    }
+
+private:
+    static constexpr std::size_t Unbound = static_cast<std::size_t>(-1);
+
+    const CompiledTemplate&    m_template;
+    std::tuple<Projections...> m_projections;
+    //! For each slot, the index of the projection giving its value.
+    std::vector<std::size_t> m_fieldOfSlot;
+
+    void Fill(std::vector<std::string_view>& values, const Row& row) const
+    {
+        const auto fields = std::apply(
+          [&row](const auto&... projection)
+          {
+              return std::array<std::string_view, sizeof...(Projections)> {
+                std::string_view {std::invoke(projection, row)}...};
+          },
+          m_projections);
+
+        for (std::size_t slot = 0; slot < values.size(); ++slot)
+        {
+            values[slot] = fields[m_fieldOfSlot[slot]];
+        }
+    }
+};
+
+#endif    // DESIGN_PATTERNS_COMPILED_TEMPLATE_H
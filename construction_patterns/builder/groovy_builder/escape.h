@@ -0,0 +1,300 @@
+/**
+ * @file    escape.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Escaping of the characters that have a meaning in HTML.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_ESCAPE_H
+#define DESIGN_PATTERNS_ESCAPE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <type_traits>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#    include <immintrin.h>
+#endif
+
+/**
+ * Returns what @c c must be replaced with in HTML, or an empty string if it can be written as-is.
+ */
+constexpr std::string_view EscapeSequence(char c)
+{
+    using namespace std::string_view_literals;
+    switch (c)
+    {
+        case '&': return "&amp;"sv;
+        case '<': return "&lt;"sv;
+        case '>': return "&gt;"sv;
+        case '"': return "&quot;"sv;
+        case '\'': return "&#39;"sv;
+        default: return {};
+    }
+}
+
+namespace Detail
+{
+constexpr bool NeedsEscaping(char c)
+{
+    return c == '&' || c == '<' || c == '>' || c == '"' || c == '\'';
+}
+
+constexpr std::size_t FindEscapableScalar(std::string_view str, std::size_t from)
+{
+    for (; from < str.size(); ++from)
+    {
+        if (NeedsEscaping(str[from]))
+        {
+            return from;
+        }
+    }
+    return str.size();
+}
+
+#if defined(__AVX2__)
+inline std::size_t FindEscapableSimd(std::string_view str, std::size_t from)
+{
+    const __m256i amp   = _mm256_set1_epi8('&');
+    const __m256i lt    = _mm256_set1_epi8('<');
+    const __m256i gt    = _mm256_set1_epi8('>');
+    const __m256i quot  = _mm256_set1_epi8('"');
+    const __m256i apos  = _mm256_set1_epi8('\'');
+    const char*   data  = str.data();
+    const auto    width = sizeof(__m256i);
+
+    for (; from + width <= str.size(); from += width)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        const __m256i found = _mm256_or_si256(
+          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, amp), _mm256_cmpeq_epi8(chunk, lt)),
+          _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, gt), _mm256_cmpeq_epi8(chunk, quot)),
+                          _mm256_cmpeq_epi8(chunk, apos)));
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return from + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return FindEscapableScalar(str, from);
+}
+#elif defined(__SSE2__)
+inline std::size_t FindEscapableSimd(std::string_view str, std::size_t from)
+{
+    const __m128i amp   = _mm_set1_epi8('&');
+    const __m128i lt    = _mm_set1_epi8('<');
+    const __m128i gt    = _mm_set1_epi8('>');
+    const __m128i quot  = _mm_set1_epi8('"');
+    const __m128i apos  = _mm_set1_epi8('\'');
+    const char*   data  = str.data();
+    const auto    width = sizeof(__m128i);
+
+    for (; from + width <= str.size(); from += width)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        const __m128i found =
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, amp), _mm_cmpeq_epi8(chunk, lt)),
+                       _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, gt), _mm_cmpeq_epi8(chunk, quot)),
+                                    _mm_cmpeq_epi8(chunk, apos)));
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return from + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return FindEscapableScalar(str, from);
+}
+#endif
+}    // namespace Detail
+
+/**
+ * Finds the first character at or after @c from that must be escaped.
+ *
+ * Scans 32 or 16 characters at a time when AVX2 or SSE2 are enabled at compile time, and one at a
+ * time otherwise.
+ *
+ * @returns The position of the character, or the size of @c str if there is none.
+ */
+constexpr std::size_t FindEscapable(std::string_view str, std::size_t from = 0)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (!std::is_constant_evaluated())
+    {
+        return Detail::FindEscapableSimd(str, from);
+    }
+#endif
+    return Detail::FindEscapableScalar(str, from);
+}
+
+/**
+ * Hands @c str to @c writer with its special characters escaped.
+ *
+ * Runs of characters that don't need escaping are appended in one go.
+ *
+ * @tparam Writer See render.h
+ */
+template<typename Writer>
+constexpr void WriteEscaped(Writer& writer, std::string_view str)
+{
+    std::size_t position = 0;
+    while (true)
+    {
+        const std::size_t special = FindEscapable(str, position);
+        if (special != position)
+        {
+            writer.Append(str.substr(position, special - position));
+        }
+        if (special == str.size())
+        {
+            return;
+        }
+        writer.Append(EscapeSequence(str[special]));
+        position = special + 1;
+    }
+}
+
+namespace Detail
+{
+/**
+ * Decodes a character reference, without its leading '&' and trailing ';'.
+ *
+ * @returns false if the reference is not one that is known.
+ */
+template<typename String>
+bool AppendCharacterReference(String& out, std::string_view reference)
+{
+    struct NamedReference
+    {
+        std::string_view Name;
+        std::string_view Value;
+    };
+    static constexpr NamedReference Named[] = {
+      {"amp", "&"}, {"lt", "<"}, {"gt", ">"}, {"quot", "\""}, {"apos", "'"}, {"nbsp", "\u00a0"}};
+
+    for (const auto& named : Named)
+    {
+        if (reference == named.Name)
+        {
+            out.append(named.Value);
+            return true;
+        }
+    }
+
+    if (reference.size() < 2 || reference.front() != '#')
+    {
+        return false;
+    }
+
+    const bool             hex    = reference[1] == 'x' || reference[1] == 'X';
+    const std::string_view digits = reference.substr(hex ? 2 : 1);
+    if (digits.empty() || digits.size() > 6)
+    {
+        return false;
+    }
+
+    std::uint32_t code = 0;
+    for (const char c : digits)
+    {
+        std::uint32_t digit = 0;
+        if (c >= '0' && c <= '9')
+        {
+            digit = static_cast<std::uint32_t>(c - '0');
+        }
+        else if (hex && (c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+        {
+            digit = static_cast<std::uint32_t>((c | 0x20) - 'a' + 10);
+        }
+        else
+        {
+            return false;
+        }
+        code = code * (hex ? 16 : 10) + digit;
+    }
+
+    if (code == 0 || code > 0x10FFFF || (code >= 0xD800 && code <= 0xDFFF))
+    {
+        return false;
+    }
+
+    // Encoded as UTF-8.
+    if (code < 0x80)
+    {
+        out += static_cast<char>(code);
+    }
+    else if (code < 0x800)
+    {
+        out += static_cast<char>(0xC0 | (code >> 6));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else if (code < 0x10000)
+    {
+        out += static_cast<char>(0xE0 | (code >> 12));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    else
+    {
+        out += static_cast<char>(0xF0 | (code >> 18));
+        out += static_cast<char>(0x80 | ((code >> 12) & 0x3F));
+        out += static_cast<char>(0x80 | ((code >> 6) & 0x3F));
+        out += static_cast<char>(0x80 | (code & 0x3F));
+    }
+    return true;
+}
+}    // namespace Detail
+
+/**
+ * Appends @c str to @c out with its character references, such as &amp;amp; or &amp;#39;, decoded.
+ *
+ * References that are not known are kept as-is.
+ */
+template<typename String>
+void AppendUnescaped(String& out, std::string_view str)
+{
+    // Longest reference that is decoded, &#x10FFFF;
+    static constexpr std::size_t MaxReferenceSize = 10;
+
+    std::size_t position = 0;
+    while (true)
+    {
+        const std::size_t amp = str.find('&', position);
+        out.append(str.substr(position, amp - position));
+        if (amp == std::string_view::npos)
+        {
+            return;
+        }
+
+        // Only as far as the longest reference, so that text full of '&' stays linear.
+        const std::size_t semicolon = str.substr(amp, MaxReferenceSize + 1).find(';');
+        if (semicolon != std::string_view::npos &&
+            Detail::AppendCharacterReference(out, str.substr(amp + 1, semicolon - 1)))
+        {
+            position = amp + semicolon + 1;
+        }
+        else
+        {
+            out += '&';
+            position = amp + 1;
+        }
+    }
+}
+
+#endif    // DESIGN_PATTERNS_ESCAPE_H
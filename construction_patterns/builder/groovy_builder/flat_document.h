@@ -0,0 +1,379 @@
+/**
+ * @file    flat_document.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Compact, contiguous representation of a tag tree.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_FLAT_DOCUMENT_H
+#define DESIGN_PATTERNS_FLAT_DOCUMENT_H
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "escape.h"
+#include "render.h"
+#include "tag.h"
+
+/**
+ * Range of characters in the string blob of a flat document.
+ */
+struct FlatString
+{
+    std::uint32_t Offset = 0;
+    std::uint32_t Size   = 0;
+};
+
+struct FlatAttribute
+{
+    //! Index of the key in the name table.
+    std::uint32_t KeyId = 0;
+    FlatString    Value;
+};
+
+/**
+ * A node of a flat document.
+ *
+ * Nodes only refer to each other by index, which makes the table relocatable.
+ */
+struct FlatNode
+{
+    static constexpr std::uint32_t None = UINT32_MAX;
+    //! The text is raw, it was not escaped.
+    static constexpr std::uint32_t RawTextFlag = 1U << 0U;
+
+    //! Index of the name of the tag in the name table.
+    std::uint32_t NameId = 0;
+    FlatString    Text;
+    //! Index of the first attribute of the node in the attribute table.
+    std::uint32_t FirstAttribute = 0;
+    std::uint32_t AttributeCount = 0;
+    std::uint32_t FirstChild     = None;
+    std::uint32_t NextSibling    = None;
+    std::uint32_t Flags          = 0;
+};
+
+/**
+ * Non-owning view over the tables of a flat document.
+ *
+ * The nodes are stored in depth-first order, the root being the first one. Texts and attribute
+ * values are stored already escaped, they are written as-is.
+ *
+ * This will translate into the exact same output as the Tag the document was made from.
+ */
+struct FlatView
+{
+    std::span<const FlatNode>      Nodes;
+    std::span<const FlatAttribute> Attributes;
+    //! Names of the tags and of the attribute keys, shared by every node.
+    std::span<const FlatString> Names;
+    std::string_view            Strings;
+
+    [[nodiscard]] std::string_view Str(FlatString str) const
+    {
+        return Strings.substr(str.Offset, str.Size);
+    }
+    [[nodiscard]] std::string_view Name(std::uint32_t id) const { return Str(Names[id]); }
+    [[nodiscard]] std::string_view NameOf(const FlatNode& node) const { return Name(node.NameId); }
+    [[nodiscard]] std::string_view TextOf(const FlatNode& node) const { return Str(node.Text); }
+    [[nodiscard]] std::span<const FlatAttribute> AttributesOf(const FlatNode& node) const
+    {
+        return Attributes.subspan(node.FirstAttribute, node.AttributeCount);
+    }
+
+    /**
+     * Builds a Tag tree out of the node at @c index and its descendants.
+     *
+     * Nothing else of the document is looked at, so part of a document can be turned back into
+     * tags without paying for the whole of it.
+     *
+     * @throws std::out_of_range if there is no such node.
+     */
+    [[nodiscard]] Tag ToTag(std::uint32_t index = 0) const
+    {
+        if (index >= Nodes.size())
+        {
+            throw std::out_of_range("No such node in the flat document");
+        }
+
+        const FlatNode& node = Nodes[index];
+        Tag             tag {TagName {NameOf(node)}, std::string_view {}};
+        tag.RawText = (node.Flags & FlatNode::RawTextFlag) != 0;
+        if (tag.RawText)
+        {
+            tag.Text.append(TextOf(node));
+        }
+        else
+        {
+            AppendUnescaped(tag.Text, TextOf(node));
+        }
+
+        tag.Attributes.reserve(node.AttributeCount);
+        for (const auto& attribute : AttributesOf(node))
+        {
+            tag.Attributes.emplace_back(AttributeKey {Name(attribute.KeyId)}, std::string_view {});
+            AppendUnescaped(tag.Attributes.back().second, Str(attribute.Value));
+        }
+
+        std::size_t childCount = 0;
+        for (std::uint32_t child = node.FirstChild; child != FlatNode::None;
+             child               = Nodes[child].NextSibling)
+        {
+            ++childCount;
+        }
+
+        tag.Children.reserve(childCount);
+        for (std::uint32_t child = node.FirstChild; child != FlatNode::None;
+             child               = Nodes[child].NextSibling)
+        {
+            tag.Children.push_back(ToTag(child));
+        }
+        return tag;
+    }
+
+    [[nodiscard]] std::size_t RenderedSize(std::size_t indent = 0) const
+    {
+        SizeCounter counter;
+        Write(counter, indent);
+        return counter.Size;
+    }
+
+    void RenderTo(std::string& out, std::size_t indent = 0) const
+    {
+        const std::size_t offset = out.size();
+        out.resize(offset + RenderedSize(indent));
+
+        BufferWriter writer {out.data() + offset};
+        Write(writer, indent);
+    }
+
+    [[nodiscard]] std::string Render(std::size_t indent = 0) const
+    {
+        std::string out;
+        RenderTo(out, indent);
+        return out;
+    }
+
+    /**
+     * Walks the nodes in order, handing the output to @c writer.
+     *
+     * The walk is iterative: the only state kept is the list of nodes that still need to be
+     * closed.
+     *
+     * @tparam Writer See render.h
+     */
+    template<typename Writer>
+    void Write(Writer& writer, std::size_t indent) const
+    {
+        if (Nodes.empty())
+        {
+            return;
+        }
+
+        std::vector<std::uint32_t> opened;
+        std::uint32_t              current = 0;
+        while (true)
+        {
+            const FlatNode&      node = Nodes[current];
+            const Markup::Layout layout {.Indent = indent + opened.size() * Tag::IndentSize};
+
+            // The strings are stored escaped already.
+            Markup::OpenTag(writer, NameOf(node), layout);
+            for (const auto& attribute : AttributesOf(node))
+            {
+                Markup::BeginAttribute(writer, Name(attribute.KeyId));
+                writer.Append(Str(attribute.Value));
+                Markup::EndAttribute(writer);
+            }
+
+            const bool empty = node.FirstChild == FlatNode::None && node.Text.Size == 0;
+            if (Markup::EndOpeningTag(writer, layout, empty, false))
+            {
+                if (node.Text.Size != 0)
+                {
+                    Markup::BeginText(writer, layout);
+                    writer.Append(TextOf(node));
+                    Markup::EndText(writer, layout);
+                }
+
+                if (node.FirstChild != FlatNode::None)
+                {
+                    opened.push_back(current);
+                    current = node.FirstChild;
+                    continue;
+                }
+
+                WriteClosing(writer, layout.Indent, node);
+            }
+
+            // Move on to the next sibling, closing the parents that have run out of children.
+            while (Nodes[current].NextSibling == FlatNode::None)
+            {
+                if (opened.empty())
+                {
+                    return;
+                }
+                current = opened.back();
+                opened.pop_back();
+                WriteClosing(writer, indent + opened.size() * Tag::IndentSize, Nodes[current]);
+            }
+            current = Nodes[current].NextSibling;
+        }
+    }
+
+private:
+    template<typename Writer>
+    void WriteClosing(Writer& writer, std::size_t width, const FlatNode& node) const
+    {
+        Markup::CloseTag(writer, NameOf(node), Markup::Layout {.Indent = width});
+    }
+};
+
+/**
+ * Owns the tables of a flat document.
+ *
+ * A flat document takes a fraction of the memory of the equivalent Tag tree, and is walked
+ * linearly instead of by chasing pointers.
+ */
+class FlatDocument
+{
+public:
+    FlatDocument() = default;
+
+    /**
+     * Converts a tag tree into a flat document.
+     */
+    static FlatDocument FromTag(const Tag& root)
+    {
+        FlatDocument document;
+        document.Append(root);
+        return document;
+    }
+
+    [[nodiscard]] FlatView View() const { return {m_nodes, m_attributes, m_names, m_strings}; }
+
+    [[nodiscard]] std::size_t NodeCount() const { return m_nodes.size(); }
+
+    /**
+     * Number of bytes used by the tables of the document.
+     */
+    [[nodiscard]] std::size_t MemoryUsage() const
+    {
+        return m_nodes.capacity() * sizeof(FlatNode) +
+               m_attributes.capacity() * sizeof(FlatAttribute) +
+               m_names.capacity() * sizeof(FlatString) + m_strings.capacity();
+    }
+
+    [[nodiscard]] std::string Render(std::size_t indent = 0) const { return View().Render(indent); }
+
+    void RenderTo(std::string& out, std::size_t indent = 0) const { View().RenderTo(out, indent); }
+
+private:
+    std::vector<FlatNode>      m_nodes;
+    std::vector<FlatAttribute> m_attributes;
+    std::vector<FlatString>    m_names;
+    std::string                m_strings;
+
+    std::unordered_map<TagName, std::uint32_t, TagName::Hash>           m_tagNameIds;
+    std::unordered_map<AttributeKey, std::uint32_t, AttributeKey::Hash> m_attributeKeyIds;
+
+    std::uint32_t Append(const Tag& tag)
+    {
+        const auto index = static_cast<std::uint32_t>(m_nodes.size());
+
+        FlatNode node;
+        node.NameId         = InternName(tag.Name);
+        node.Text           = tag.RawText ? AddString(tag.Text) : AddEscapedString(tag.Text);
+        node.FirstAttribute = static_cast<std::uint32_t>(m_attributes.size());
+        node.AttributeCount = static_cast<std::uint32_t>(tag.Attributes.size());
+        node.Flags          = tag.RawText ? FlatNode::RawTextFlag : 0;
+        for (const auto& [key, value] : tag.Attributes)
+        {
+            m_attributes.push_back({InternName(key), AddEscapedString(value)});
+        }
+        m_nodes.push_back(node);
+
+        // Generated children are flattened like any other.
+        std::uint32_t previous = FlatNode::None;
+        tag.ForEachChild(
+          [&](const Tag& child)
+          {
+              const std::uint32_t childIndex = Append(child);
+              if (previous == FlatNode::None)
+              {
+                  m_nodes[index].FirstChild = childIndex;
+              }
+              else
+              {
+                  m_nodes[previous].NextSibling = childIndex;
+              }
+              previous = childIndex;
+          });
+
+        return index;
+    }
+
+    template<typename Traits>
+    std::uint32_t InternName(const Symbol<Traits>& name)
+    {
+        auto& ids = [this]() -> auto&
+        {
+            if constexpr (std::same_as<Traits, TagNameTraits>)
+            {
+                return m_tagNameIds;
+            }
+            else
+            {
+                return m_attributeKeyIds;
+            }
+        }();
+        const auto [it, inserted] = ids.try_emplace(name, static_cast<std::uint32_t>(m_names.size()));
+        if (inserted)
+        {
+            m_names.push_back(AddString(name.View()));
+        }
+        return it->second;
+    }
+
+    FlatString AddString(std::string_view str)
+    {
+        const FlatString out {static_cast<std::uint32_t>(m_strings.size()),
+                              static_cast<std::uint32_t>(str.size())};
+        m_strings.append(str);
+        return out;
+    }
+
+    FlatString AddEscapedString(std::string_view str)
+    {
+        const auto   offset = static_cast<std::uint32_t>(m_strings.size());
+        StringWriter writer {m_strings};
+        WriteEscaped(writer, str);
+        return {offset, static_cast<std::uint32_t>(m_strings.size() - offset)};
+    }
+};
+
+#endif    // DESIGN_PATTERNS_FLAT_DOCUMENT_H
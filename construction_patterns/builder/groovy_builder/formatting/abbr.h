@@ -33,9 +33,9 @@
  */
 struct Abbr : Tag
 {
-    Abbr(std::string acronym, std::string definition) : Tag("abbr", acronym)
+    Abbr(std::string_view acronym, std::string_view definition) : Tag(TagId::Abbr, acronym)
     {
-        Attributes.emplace_back("title", definition);
+        Attributes.emplace_back(AttributeId::Title, definition);
     }
 };
 
@@ -29,6 +29,15 @@
 
 struct Address : Tag
 {
-    Address(std::initializer_list<Tag> children) : Tag("address", children) {}
+    template<typename... Tags>
+        requires ChildTagsOf<Address, Tags...>
+    Address(Tags&&... children) : Tag(TagId::Address, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    template<typename View>
+        requires ChildTagView<View>
+    Address(View&& children) : Tag(TagId::Address, std::forward<View>(children))
+    {
+    }
 };
 #endif    // DESIGN_PATTERNS_ADDRESS_H
@@ -30,6 +30,6 @@
 
 struct B : Tag
 {
-    B(std::string text) : Tag("b", text) {}
+    B(std::string_view text) : Tag(TagId::B, text) {}
 };
 #endif    // DESIGN_PATTERNS_B_H
@@ -35,6 +35,6 @@
  */
 struct Bdi : Tag
 {
-    Bdi(std::string text) : Tag("bdi", text) {}
+    Bdi(std::string_view text) : Tag(TagId::Bdi, text) {}
 };
 #endif    // DESIGN_PATTERNS_BDI_H
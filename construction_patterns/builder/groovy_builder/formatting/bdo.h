@@ -38,9 +38,9 @@ struct Bdo : Tag
         Rtl         //!< Right to left.
     };
 
-    Bdo(Direction dir, std::string text) : Tag("bdo", text)
+    Bdo(Direction dir, std::string_view text) : Tag(TagId::Bdo, text)
     {
-        Attributes.emplace_back("dir", DirectionToStr(dir));
+        Attributes.emplace_back(AttributeId::Dir, DirectionToStr(dir));
     }
 
 private:
@@ -29,11 +29,11 @@
 
 struct Blockquote : Tag
 {
-    Blockquote(std::string text, std::string source = "") : Tag("blockquote", text)
+    Blockquote(std::string_view text, std::string_view source = {}) : Tag(TagId::Blockquote, text)
     {
         if (!source.empty())
         {
-            Attributes.emplace_back("cite", source);
+            Attributes.emplace_back(AttributeId::Cite, source);
         }
     }
 };
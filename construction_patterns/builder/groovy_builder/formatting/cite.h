@@ -29,6 +29,6 @@
 
 struct Cite : Tag
 {
-    Cite(std::string text) : Tag("cite", text) {}
+    Cite(std::string_view text) : Tag(TagId::Cite, text) {}
 };
 #endif    // DESIGN_PATTERNS_CITE_H
@@ -30,6 +30,10 @@
 
 struct Code : Tag
 {
-    Code(std::string text) : Tag("code", std::move(text)) {}
+    Code(std::string_view text) : Tag(TagId::Code, text)
+    {
+        // Code is written as-is, it is up to the caller to make sure that it is valid HTML.
+        RawText = true;
+    }
 };
 #endif    // DESIGN_PATTERNS_CODEBUILDER_H
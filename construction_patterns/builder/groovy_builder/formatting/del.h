@@ -29,6 +29,6 @@
 
 struct Del : Tag
 {
-    Del(std::string text) : Tag("del", text) {}
+    Del(std::string_view text) : Tag(TagId::Del, text) {}
 };
 #endif    // DESIGN_PATTERNS_DEL_H
@@ -0,0 +1,173 @@
+/**
+ * @file    generator.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Coroutine that lazily yields a sequence of values.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_GENERATOR_H
+#define DESIGN_PATTERNS_GENERATOR_H
+
+#include <coroutine>
+#include <cstddef>
+#include <exception>
+#include <iterator>
+#include <memory>
+#include <utility>
+
+/**
+ * Coroutine whose body runs only when the next value is pulled, up to its next co_yield.
+ *
+ * Values are held by reference: each one is valid until the generator is resumed.
+ *
+ * @code
+ * Generator<int> Count(int n)
+ * {
+ *     for (int i = 0; i < n; ++i)
+ *     {
+ *         co_yield i;
+ *     }
+ * }
+ * @endcode
+ */
+template<typename T>
+class Generator
+{
+public:
+    struct promise_type
+    {
+        const T*           Current = nullptr;
+        std::exception_ptr Error;
+
+        Generator get_return_object()
+        {
+            return Generator {std::coroutine_handle<promise_type>::from_promise(*this)};
+        }
+        std::suspend_always initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        std::suspend_always yield_value(const T& value) noexcept
+        {
+            Current = std::addressof(value);
+            return {};
+        }
+        void return_void() noexcept {}
+        void unhandled_exception() noexcept { Error = std::current_exception(); }
+
+        // co_await is not meant to be used in generators.
+        template<typename U>
+        std::suspend_never await_transform(U&&) = delete;
+    };
+
+    class Iterator
+    {
+    public:
+        using iterator_category = std::input_iterator_tag;
+        using difference_type   = std::ptrdiff_t;
+        using value_type        = T;
+        using reference         = const T&;
+        using pointer           = const T*;
+
+        Iterator() = default;
+        explicit Iterator(Generator* generator) : m_generator(generator) {}
+
+        reference operator*() const { return *m_generator->m_handle.promise().Current; }
+        pointer   operator->() const { return m_generator->m_handle.promise().Current; }
+
+        Iterator& operator++()
+        {
+            if (!m_generator->Advance())
+            {
+                m_generator = nullptr;
+            }
+            return *this;
+        }
+        void operator++(int) { ++*this; }
+
+        friend bool operator==(const Iterator& it, std::default_sentinel_t) noexcept
+        {
+            return it.m_generator == nullptr;
+        }
+
+    private:
+        Generator* m_generator = nullptr;
+    };
+
+    Generator(const Generator&)            = delete;
+    Generator& operator=(const Generator&) = delete;
+    Generator(Generator&& other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Generator& operator=(Generator&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+        return *this;
+    }
+    ~Generator() { Destroy(); }
+
+    /**
+     * Runs the coroutine up to its next value.
+     *
+     * @returns The value, valid until the next call, or nullptr once the coroutine is done.
+     * @throws Whatever the coroutine threw.
+     */
+    const T* Next() { return Advance() ? m_handle.promise().Current : nullptr; }
+
+    /**
+     * Starts the coroutine, iterating resumes it.
+     */
+    Iterator begin()
+    {
+        return Advance() ? Iterator {this} : Iterator {};
+    }
+    std::default_sentinel_t end() const noexcept { return {}; }
+
+private:
+    std::coroutine_handle<promise_type> m_handle;
+
+    explicit Generator(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    bool Advance()
+    {
+        if (!m_handle || m_handle.done())
+        {
+            return false;
+        }
+
+        m_handle.resume();
+        if (m_handle.promise().Error)
+        {
+            std::rethrow_exception(std::exchange(m_handle.promise().Error, nullptr));
+        }
+        return !m_handle.done();
+    }
+
+    void Destroy() noexcept
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+    }
+};
+
+#endif    // DESIGN_PATTERNS_GENERATOR_H
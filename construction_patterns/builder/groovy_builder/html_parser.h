@@ -0,0 +1,845 @@
+/**
+ * @file    html_parser.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Zero-copy HTML parser.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_HTML_PARSER_H
+#define DESIGN_PATTERNS_HTML_PARSER_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include "escape.h"
+#include "names.h"
+#include "tag.h"
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#    include <immintrin.h>
+#endif
+
+/**
+ * Thrown when a document is too malformed to be parsed.
+ */
+class HtmlParseError : public std::runtime_error
+{
+public:
+    HtmlParseError(const std::string& what, std::size_t offset)
+    : std::runtime_error(what + " at offset " + std::to_string(offset)), m_offset(offset)
+    {
+    }
+
+    //! Position in the source of the construct that could not be parsed.
+    [[nodiscard]] std::size_t Offset() const noexcept { return m_offset; }
+
+private:
+    std::size_t m_offset;
+};
+
+namespace Detail
+{
+constexpr bool IsMarkup(char c)
+{
+    return c == '<' || c == '>' || c == '"' || c == '=';
+}
+
+constexpr bool IsHtmlSpace(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\f';
+}
+
+constexpr std::size_t FindMarkupScalar(std::string_view str, std::size_t from)
+{
+    for (; from < str.size(); ++from)
+    {
+        if (IsMarkup(str[from]))
+        {
+            return from;
+        }
+    }
+    return str.size();
+}
+
+#if defined(__AVX2__)
+inline std::size_t FindMarkupSimd(std::string_view str, std::size_t from)
+{
+    const __m256i lt     = _mm256_set1_epi8('<');
+    const __m256i gt     = _mm256_set1_epi8('>');
+    const __m256i quot   = _mm256_set1_epi8('"');
+    const __m256i equals = _mm256_set1_epi8('=');
+    const char*   data   = str.data();
+    const auto    width  = sizeof(__m256i);
+
+    for (; from + width <= str.size(); from += width)
+    {
+        const __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + from));
+        const __m256i found =
+          _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, lt), _mm256_cmpeq_epi8(chunk, gt)),
+                          _mm256_or_si256(_mm256_cmpeq_epi8(chunk, quot), _mm256_cmpeq_epi8(chunk, equals)));
+        const auto mask = static_cast<unsigned int>(_mm256_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return from + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return FindMarkupScalar(str, from);
+}
+#elif defined(__SSE2__)
+inline std::size_t FindMarkupSimd(std::string_view str, std::size_t from)
+{
+    const __m128i lt     = _mm_set1_epi8('<');
+    const __m128i gt     = _mm_set1_epi8('>');
+    const __m128i quot   = _mm_set1_epi8('"');
+    const __m128i equals = _mm_set1_epi8('=');
+    const char*   data   = str.data();
+    const auto    width  = sizeof(__m128i);
+
+    for (; from + width <= str.size(); from += width)
+    {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + from));
+        const __m128i found =
+          _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, lt), _mm_cmpeq_epi8(chunk, gt)),
+                       _mm_or_si128(_mm_cmpeq_epi8(chunk, quot), _mm_cmpeq_epi8(chunk, equals)));
+        const auto mask = static_cast<unsigned int>(_mm_movemask_epi8(found));
+        if (mask != 0)
+        {
+            return from + static_cast<std::size_t>(__builtin_ctz(mask));
+        }
+    }
+    return FindMarkupScalar(str, from);
+}
+#endif
+
+constexpr std::string_view TrimHtmlSpaces(std::string_view str)
+{
+    while (!str.empty() && IsHtmlSpace(str.front()))
+    {
+        str.remove_prefix(1);
+    }
+    while (!str.empty() && IsHtmlSpace(str.back()))
+    {
+        str.remove_suffix(1);
+    }
+    return str;
+}
+
+constexpr char ToAsciiLower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+constexpr bool IsAsciiAlpha(char c)
+{
+    return ToAsciiLower(c) >= 'a' && ToAsciiLower(c) <= 'z';
+}
+
+//! Compares two names the way HTML does, ignoring the case of ASCII letters.
+constexpr bool EqualsIgnoringCase(std::string_view lhs, std::string_view rhs)
+{
+    return std::ranges::equal(
+      lhs, rhs, [](char l, char r) { return ToAsciiLower(l) == ToAsciiLower(r); });
+}
+
+/**
+ * Tells if the parser closes an open paragraph when it meets this tag.
+ *
+ * This is a superset of ClosesParagraph(), which only lists the tags after which the renderer may
+ * leave a paragraph unclosed.
+ */
+constexpr bool ClosesParagraphWhenParsed(TagId id, std::string_view name)
+{
+    if (ClosesParagraph(id) || id == TagId::Li)
+    {
+        return true;
+    }
+    if (id != TagId::Custom)
+    {
+        return false;
+    }
+
+    constexpr std::array<std::string_view, 25> others = {
+      "article", "aside",   "center", "dd",     "details", "dialog", "dir",    "dl",     "dt",
+      "fieldset", "figcaption", "figure", "footer", "form", "header", "hgroup", "listing", "main",
+      "menu",    "nav",     "plaintext", "pre", "search",  "table",  "xmp"};
+    return std::ranges::find(others, name) != others.end();
+}
+
+//! Tags past which the parser doesn't look for a paragraph to close, the "button scope" of HTML.
+inline constexpr std::array<std::string_view, 10> ButtonScopeBoundaries = {
+  "applet", "button", "caption", "html", "marquee", "object", "table", "td", "template", "th"};
+
+/**
+ * Tags past which the parser doesn't look for a list item to close: those of the "special"
+ * category of HTML, except for address, div and p, which can't contain a list.
+ */
+inline constexpr std::array<std::string_view, 55> ListItemScopeBoundaries = {
+  "applet",   "article", "aside",    "blockquote", "body",    "button",   "caption", "center",
+  "colgroup", "details", "dir",      "dl",         "fieldset", "figcaption", "figure", "footer",
+  "form",     "frameset", "h1",      "h2",         "h3",      "h4",       "h5",      "h6",
+  "head",     "header",  "hgroup",   "html",       "iframe",  "listing",  "main",    "marquee",
+  "menu",     "nav",     "noembed",  "noframes",   "noscript", "object",  "ol",      "plaintext",
+  "pre",      "search",  "section",  "select",     "summary", "table",    "tbody",   "td",
+  "template", "tfoot",   "th",       "thead",      "tr",      "ul",       "xmp"};
+
+class HtmlParser;
+}    // namespace Detail
+
+/**
+ * Finds the first character at or after @c from that delimits markup: '<', '>', '"' or '='.
+ *
+ * Scans 32 or 16 characters at a time when AVX2 or SSE2 are enabled at compile time, and one at a
+ * time otherwise.
+ *
+ * @returns The position of the character, or the size of @c str if there is none.
+ */
+constexpr std::size_t FindMarkup(std::string_view str, std::size_t from = 0)
+{
+#if defined(__AVX2__) || defined(__SSE2__)
+    if (!std::is_constant_evaluated())
+    {
+        return Detail::FindMarkupSimd(str, from);
+    }
+#endif
+    return Detail::FindMarkupScalar(str, from);
+}
+
+struct ParsedAttribute
+{
+    std::string_view Key;
+    //! Value as found in the source, still escaped. Empty for an attribute without a value.
+    std::string_view Value;
+};
+
+/**
+ * A node of a parsed document.
+ *
+ * Nodes are either tags or runs of text. Since a Tag only has a single text, coming before its
+ * children, the text found directly inside a tag before its first child is kept on the tag itself,
+ * and any further run of text becomes a node of its own.
+ */
+struct ParsedNode
+{
+    static constexpr std::uint32_t None = UINT32_MAX;
+
+    //! Name of the tag, as written in the source. Empty for a run of text.
+    std::string_view Name;
+    //! Text with the surrounding white spaces removed, still escaped.
+    std::string_view Text;
+    //! Index of the first attribute of the node in the attribute table.
+    std::uint32_t FirstAttribute = 0;
+    std::uint32_t AttributeCount = 0;
+    std::uint32_t FirstChild     = None;
+    std::uint32_t NextSibling    = None;
+
+    [[nodiscard]] bool IsText() const noexcept { return Name.empty(); }
+};
+
+/**
+ * Flat view of an HTML document, whose names, texts and attributes all refer to the source.
+ *
+ * Nothing is copied or decoded while parsing: the source, which can be a MappedFile, must outlive
+ * the document. The nodes are stored in depth-first order, top-level nodes being linked as
+ * siblings of the first one.
+ *
+ * The parser is lenient, like browsers are: closing tags that HTML allows to omit are inferred,
+ * stray closing tags are ignored, and tags still open at the end of the source are closed there.
+ * Comments, doctypes and processing instructions are skipped.
+ */
+class ParsedDocument
+{
+public:
+    /**
+     * @throws HtmlParseError on an unterminated tag, attribute value or comment.
+     */
+    static ParsedDocument Parse(std::string_view source);
+
+    [[nodiscard]] std::string_view             Source() const noexcept { return m_source; }
+    [[nodiscard]] std::span<const ParsedNode>  Nodes() const noexcept { return m_nodes; }
+    [[nodiscard]] std::size_t                  NodeCount() const noexcept { return m_nodes.size(); }
+    [[nodiscard]] std::span<const ParsedAttribute> AttributesOf(const ParsedNode& node) const
+    {
+        return std::span {m_attributes}.subspan(node.FirstAttribute, node.AttributeCount);
+    }
+
+    /**
+     * Builds a Tag tree out of the first top-level tag of the document.
+     *
+     * Unlike the document, the tree owns its strings, with their character references decoded.
+     *
+     * @throws std::out_of_range if the document has no tag.
+     */
+    [[nodiscard]] Tag ToTag() const
+    {
+        for (std::uint32_t index = 0; index < m_nodes.size(); index = m_nodes[index].NextSibling)
+        {
+            if (!m_nodes[index].IsText())
+            {
+                return ToTag(index);
+            }
+        }
+        throw std::out_of_range("The document has no tag");
+    }
+
+    /**
+     * Builds a Tag tree out of the node at @c index.
+     *
+     * The runs of text that follow the children of a tag are appended to its text, separated by a
+     * space.
+     *
+     * @throws std::out_of_range if there is no such node.
+     * @throws std::invalid_argument if the node is a run of text.
+     */
+    [[nodiscard]] Tag ToTag(std::uint32_t index) const
+    {
+        Names names;
+        return ToTag(index, names);
+    }
+
+private:
+    friend class Detail::HtmlParser;
+
+    //! Symbols of the names found in the document, each custom one only being stored once.
+    struct Names
+    {
+        SymbolCache<TagNameTraits>      Tags;
+        SymbolCache<AttributeKeyTraits> Attributes;
+    };
+
+    std::string_view             m_source;
+    std::vector<ParsedNode>      m_nodes;
+    std::vector<ParsedAttribute> m_attributes;
+
+    [[nodiscard]] Tag ToTag(std::uint32_t index, Names& names) const
+    {
+        const ParsedNode& node = m_nodes.at(index);
+        if (node.IsText())
+        {
+            throw std::invalid_argument("A run of text cannot be turned into a tag");
+        }
+
+        Tag tag {names.Tags(node.Name), std::string_view {}};
+        tag.RawText = IsRawTextElement(node.Name);
+        AppendText(tag, node.Text);
+
+        tag.Attributes.reserve(node.AttributeCount);
+        for (const auto& attribute : AttributesOf(node))
+        {
+            tag.Attributes.emplace_back(names.Attributes(attribute.Key), std::string_view {});
+            AppendUnescaped(tag.Attributes.back().second, attribute.Value);
+        }
+
+        std::size_t childCount = 0;
+        for (std::uint32_t child = node.FirstChild; child != ParsedNode::None;
+             child               = m_nodes[child].NextSibling)
+        {
+            childCount += m_nodes[child].IsText() ? 0 : 1;
+        }
+
+        tag.Children.reserve(childCount);
+        for (std::uint32_t child = node.FirstChild; child != ParsedNode::None;
+             child               = m_nodes[child].NextSibling)
+        {
+            if (m_nodes[child].IsText())
+            {
+                if (!tag.Text.empty())
+                {
+                    tag.Text += ' ';
+                }
+                AppendText(tag, m_nodes[child].Text);
+            }
+            else
+            {
+                tag.Children.push_back(ToTag(child, names));
+            }
+        }
+        return tag;
+    }
+
+    //! Tags whose content is only text, never markup, and is kept as-is.
+    static bool IsRawTextElement(std::string_view name)
+    {
+        return Detail::EqualsIgnoringCase(name, "script") || Detail::EqualsIgnoringCase(name, "style");
+    }
+
+    static void AppendText(Tag& tag, std::string_view text)
+    {
+        if (tag.RawText)
+        {
+            tag.Text.append(text);
+        }
+        else
+        {
+            AppendUnescaped(tag.Text, text);
+        }
+    }
+};
+
+namespace Detail
+{
+class HtmlParser
+{
+public:
+    HtmlParser(ParsedDocument& document, std::string_view source)
+    : m_document(document), m_source(source)
+    {
+    }
+
+    void Run()
+    {
+        std::size_t text = 0;
+        while (true)
+        {
+            const std::size_t open = Find('<', m_position);
+            if (open == m_source.size())
+            {
+                AddText(m_source.substr(text));
+                return;
+            }
+
+            // A '<' that starts no markup, as in "a < b", is part of the text.
+            if (!StartsMarkup(open))
+            {
+                m_position = open + 1;
+                continue;
+            }
+
+            AddText(m_source.substr(text, open - text));
+            m_position = open;
+            if (m_source.substr(m_position, 4) == "<!--")
+            {
+                SkipComment();
+            }
+            else if (m_source.substr(m_position, 2) == "<!" || m_source.substr(m_position, 2) == "<?")
+            {
+                m_position = FindOrThrow('>', m_position, "Unterminated declaration") + 1;
+            }
+            else if (m_source.substr(m_position, 2) == "</")
+            {
+                ParseClosing();
+            }
+            else
+            {
+                ParseOpening();
+            }
+            text = m_position;
+        }
+    }
+
+private:
+    //! A tag waiting for its closing tag.
+    struct Open
+    {
+        std::uint32_t Index;
+        TagId         Id;
+        std::uint32_t LastChild = ParsedNode::None;
+    };
+
+    ParsedDocument&   m_document;
+    std::string_view  m_source;
+    std::size_t       m_position = 0;
+    std::vector<Open> m_open;
+    std::uint32_t     m_lastRoot = ParsedNode::None;
+    //! Name of the tag being opened in lower case, kept to reuse its storage.
+    std::string       m_lowerName;
+
+    /**
+     * Finds the next occurrence of one of the markup characters.
+     */
+    [[nodiscard]] std::size_t Find(char markup, std::size_t from) const
+    {
+        std::size_t found = FindMarkup(m_source, from);
+        while (found != m_source.size() && m_source[found] != markup)
+        {
+            found = FindMarkup(m_source, found + 1);
+        }
+        return found;
+    }
+
+    //! Tells if the '<' at @c open starts a tag, a closing tag, a comment or a declaration.
+    [[nodiscard]] bool StartsMarkup(std::size_t open) const
+    {
+        if (open + 1 >= m_source.size())
+        {
+            return false;
+        }
+        const char next = m_source[open + 1];
+        return IsAsciiAlpha(next) || next == '/' || next == '!' || next == '?';
+    }
+
+    std::size_t FindOrThrow(char markup, std::size_t from, const char* error) const
+    {
+        const std::size_t found = Find(markup, from);
+        if (found == m_source.size())
+        {
+            throw HtmlParseError(error, from);
+        }
+        return found;
+    }
+
+    void SkipSpaces()
+    {
+        while (m_position < m_source.size() && IsHtmlSpace(m_source[m_position]))
+        {
+            ++m_position;
+        }
+    }
+
+    /**
+     * Reads a name, up to a white space or one of @c stops.
+     */
+    std::string_view ReadName(std::string_view stops)
+    {
+        const std::size_t start = m_position;
+        while (m_position < m_source.size() && !IsHtmlSpace(m_source[m_position]) &&
+               stops.find(m_source[m_position]) == std::string_view::npos)
+        {
+            ++m_position;
+        }
+        return m_source.substr(start, m_position - start);
+    }
+
+    std::uint32_t AddNode(std::string_view name, std::string_view text)
+    {
+        auto&       nodes = m_document.m_nodes;
+        const auto  index = static_cast<std::uint32_t>(nodes.size());
+        nodes.push_back(ParsedNode {.Name = name, .Text = text});
+
+        if (m_open.empty())
+        {
+            if (m_lastRoot != ParsedNode::None)
+            {
+                nodes[m_lastRoot].NextSibling = index;
+            }
+            m_lastRoot = index;
+        }
+        else
+        {
+            Open& parent = m_open.back();
+            if (parent.LastChild == ParsedNode::None)
+            {
+                nodes[parent.Index].FirstChild = index;
+            }
+            else
+            {
+                nodes[parent.LastChild].NextSibling = index;
+            }
+            parent.LastChild = index;
+        }
+        return index;
+    }
+
+    void AddText(std::string_view text)
+    {
+        text = TrimHtmlSpaces(text);
+        if (text.empty())
+        {
+            return;
+        }
+
+        if (!m_open.empty())
+        {
+            ParsedNode& parent = m_document.m_nodes[m_open.back().Index];
+            if (parent.FirstChild == ParsedNode::None && parent.Text.empty())
+            {
+                parent.Text = text;
+                return;
+            }
+        }
+        AddNode({}, text);
+    }
+
+    void SkipComment()
+    {
+        const std::size_t end = m_source.find("-->", m_position + 4);
+        if (end == std::string_view::npos)
+        {
+            throw HtmlParseError("Unterminated comment", m_position);
+        }
+        m_position = end + 3;
+    }
+
+    /**
+     * Closes the tags that are implicitly closed by the opening of a tag, as the HTML parsing
+     * algorithm does for the tags whose closing tag can be omitted.
+     */
+    void CloseImplicitly(TagId opening, std::string_view name)
+    {
+        if (opening == TagId::Body)
+        {
+            CloseCurrent({"head"});
+            return;
+        }
+
+        if (ClosesParagraphWhenParsed(opening, name))
+        {
+            CloseUpTo({"p"}, ButtonScopeBoundaries);
+        }
+
+        if (opening == TagId::Li)
+        {
+            CloseUpTo({"li"}, ListItemScopeBoundaries);
+        }
+        else if (name == "dd" || name == "dt")
+        {
+            CloseUpTo({"dd", "dt"}, ListItemScopeBoundaries);
+        }
+        else if (opening >= TagId::H1 && opening <= TagId::H6)
+        {
+            CloseCurrent({"h1", "h2", "h3", "h4", "h5", "h6"});
+        }
+        else if (name == "option")
+        {
+            CloseCurrent({"option"});
+        }
+        else if (name == "optgroup")
+        {
+            CloseCurrent({"option"});
+            CloseCurrent({"optgroup"});
+        }
+        else if (name == "rb" || name == "rtc")
+        {
+            CloseUpTo({"rb", "rp", "rt", "rtc"}, {"ruby"});
+        }
+        else if (name == "rp" || name == "rt")
+        {
+            CloseUpTo({"rb", "rp", "rt"}, {"ruby", "rtc"});
+        }
+        else if (name == "td" || name == "th")
+        {
+            CloseUpTo({"td", "th"}, {"tr", "table"});
+        }
+        else if (name == "tr")
+        {
+            CloseUpTo({"tr"}, {"tbody", "thead", "tfoot", "table"});
+        }
+        else if (name == "tbody" || name == "thead" || name == "tfoot")
+        {
+            CloseUpTo({"tbody", "thead", "tfoot"}, {"table"});
+        }
+    }
+
+    /**
+     * Closes the innermost open tag named one of @c names, along with everything open inside of
+     * it, unless a tag named one of @c boundaries is found first.
+     */
+    template<typename Boundaries = std::initializer_list<std::string_view>>
+    void CloseUpTo(std::initializer_list<std::string_view> names, const Boundaries& boundaries)
+    {
+        for (std::size_t i = m_open.size(); i != 0; --i)
+        {
+            const std::string_view open  = m_document.m_nodes[m_open[i - 1].Index].Name;
+            const auto             named = [open](std::string_view name)
+            { return EqualsIgnoringCase(name, open); };
+            if (std::ranges::any_of(names, named))
+            {
+                m_open.resize(i - 1);
+                return;
+            }
+            if (std::ranges::any_of(boundaries, named))
+            {
+                return;
+            }
+        }
+    }
+
+    //! Closes the current tag if it is named one of @c names.
+    void CloseCurrent(std::initializer_list<std::string_view> names)
+    {
+        if (m_open.empty())
+        {
+            return;
+        }
+        const std::string_view open = m_document.m_nodes[m_open.back().Index].Name;
+        if (std::ranges::any_of(names,
+                                [open](std::string_view name)
+                                { return EqualsIgnoringCase(name, open); }))
+        {
+            m_open.pop_back();
+        }
+    }
+
+    void ParseOpening()
+    {
+        const std::size_t start = m_position++;
+        const auto        name  = ReadName("/>");
+        if (name.empty())
+        {
+            throw HtmlParseError("Expected a tag name", start);
+        }
+
+        // The node keeps the name as written, the rules of HTML are looked up in lower case.
+        m_lowerName.resize(name.size());
+        std::ranges::transform(name, m_lowerName.begin(), ToAsciiLower);
+        const std::string_view lower = m_lowerName;
+
+        const TagId id = FindTagId(lower);
+        CloseImplicitly(id, lower);
+        const std::uint32_t index = AddNode(name, {});
+
+        auto&       attributes  = m_document.m_attributes;
+        const auto  first       = static_cast<std::uint32_t>(attributes.size());
+        bool        selfClosing = false;
+        while (true)
+        {
+            SkipSpaces();
+            if (m_position >= m_source.size())
+            {
+                throw HtmlParseError("Unterminated tag", start);
+            }
+
+            const char c = m_source[m_position];
+            if (c == '>')
+            {
+                ++m_position;
+                break;
+            }
+            if (c == '/')
+            {
+                ++m_position;
+                selfClosing = m_position < m_source.size() && m_source[m_position] == '>';
+                continue;
+            }
+
+            const std::size_t keyStart = m_position;
+            const auto        key      = ReadName("/>=");
+            if (key.empty())
+            {
+                throw HtmlParseError("Expected an attribute name", keyStart);
+            }
+
+            SkipSpaces();
+            std::string_view value;
+            if (m_position < m_source.size() && m_source[m_position] == '=')
+            {
+                ++m_position;
+                SkipSpaces();
+                value = ReadAttributeValue();
+            }
+            attributes.push_back(ParsedAttribute {key, value});
+        }
+
+        ParsedNode& node    = m_document.m_nodes[index];
+        node.FirstAttribute = first;
+        node.AttributeCount = static_cast<std::uint32_t>(attributes.size()) - first;
+
+        if (selfClosing || IsVoidElement(id, lower))
+        {
+            return;
+        }
+        if (lower == "script" || lower == "style" || lower == "title" || lower == "textarea")
+        {
+            ReadRawText(node, start);
+            return;
+        }
+        m_open.push_back(Open {index, id});
+    }
+
+    std::string_view ReadAttributeValue()
+    {
+        if (m_position >= m_source.size())
+        {
+            return {};
+        }
+
+        const char quote = m_source[m_position];
+        if (quote == '"' || quote == '\'')
+        {
+            const std::size_t start = m_position + 1;
+            const std::size_t end   = quote == '"' ? Find('"', start) : m_source.find('\'', start);
+            if (end == m_source.size() || end == std::string_view::npos)
+            {
+                throw HtmlParseError("Unterminated attribute value", m_position);
+            }
+            m_position = end + 1;
+            return m_source.substr(start, end - start);
+        }
+        return ReadName(">");
+    }
+
+    /**
+     * Takes everything up to the closing tag as the text of @c node, markup included.
+     */
+    void ReadRawText(ParsedNode& node, std::size_t start)
+    {
+        const std::size_t contentStart = m_position;
+        std::size_t       end          = contentStart;
+        while (true)
+        {
+            end = m_source.find("</", end);
+            if (end == std::string_view::npos)
+            {
+                throw HtmlParseError("Unterminated <" + std::string {node.Name} + ">", start);
+            }
+            // The name must be followed by the end of the tag: </scriptx doesn't close a <script>.
+            const std::size_t after = end + 2 + node.Name.size();
+            if (after < m_source.size() &&
+                EqualsIgnoringCase(m_source.substr(end + 2, node.Name.size()), node.Name) &&
+                (m_source[after] == '>' || m_source[after] == '/' || IsHtmlSpace(m_source[after])))
+            {
+                break;
+            }
+            end += 2;
+        }
+
+        node.Text  = TrimHtmlSpaces(m_source.substr(contentStart, end - contentStart));
+        m_position = FindOrThrow('>', end, "Unterminated closing tag") + 1;
+    }
+
+    void ParseClosing()
+    {
+        const std::size_t start = m_position;
+        m_position += 2;
+        const auto name = ReadName(">");
+        m_position      = FindOrThrow('>', start, "Unterminated closing tag") + 1;
+
+        // Closing a tag also closes whatever was left open inside of it. A closing tag that matches
+        // nothing is ignored.
+        for (std::size_t i = m_open.size(); i != 0; --i)
+        {
+            if (EqualsIgnoringCase(m_document.m_nodes[m_open[i - 1].Index].Name, name))
+            {
+                m_open.resize(i - 1);
+                return;
+            }
+        }
+    }
+};
+}    // namespace Detail
+
+inline ParsedDocument ParsedDocument::Parse(std::string_view source)
+{
+    ParsedDocument document;
+    document.m_source = source;
+    Detail::HtmlParser {document, source}.Run();
+    return document;
+}
+
+#endif    // DESIGN_PATTERNS_HTML_PARSER_H
@@ -29,10 +29,10 @@
 
 struct Img : Tag
 {
-    explicit Img(std::string url) : Tag("img", "")
+    explicit Img(std::string_view url) : Tag(TagId::Img, "")
     {
         // The URL of an image is in the attribute list of the tag.
-        Attributes.emplace_back("src", url);
+        Attributes.emplace_back(AttributeId::Src, url);
     }
 };
 
@@ -0,0 +1,47 @@
+/**
+ * @file    li.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_LI_H
+#define DESIGN_PATTERNS_LI_H
+
+#include "../tag.h"
+
+#include <utility>
+
+struct Li : Tag
+{
+    Li(std::string_view text) : Tag(TagId::Li, text) {}
+    template<typename... Tags>
+        requires ChildTagsOf<Li, Tags...>
+    Li(Tags&&... children) : Tag(TagId::Li, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    template<typename View>
+        requires ChildTagView<View>
+    Li(View&& children) : Tag(TagId::Li, std::forward<View>(children))
+    {
+    }
+};
+
+#endif    // DESIGN_PATTERNS_LI_H
@@ -0,0 +1,275 @@
+/**
+ * @file    live_document.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Document that only re-renders the parts that changed.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_LIVE_DOCUMENT_H
+#define DESIGN_PATTERNS_LIVE_DOCUMENT_H
+
+#include <algorithm>
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "names.h"
+#include "render.h"
+#include "tag.h"
+
+struct FragmentCacheStats
+{
+    //! Number of subtrees whose cached output was reused.
+    std::size_t Hits = 0;
+    //! Number of nodes that had to be rendered again.
+    std::size_t Misses = 0;
+};
+
+/**
+ * Owns a tag tree and keeps the rendered output of each of its subtrees.
+ *
+ * The tree can only be modified through Node handles, which mark the modified node and all of its
+ * parents as dirty. Rendering the document again only re-renders the dirty nodes, the output of
+ * every other subtree is copied from the cache in one go:
+ *  LiveDocument document {Html { Body { H1 {"Title"}, P {"Text"} } }};
+ *  send(document.Render());
+ *  document.Root().Child(0).Child(1).SetText("Other text");
+ *  send(document.Render());    // Only <p>, <body> and <html> are rendered.
+ *
+ * Since every node keeps the output of its whole subtree, the cache takes about as many times the
+ * size of the output as the document is deep.
+ */
+class LiveDocument
+{
+    struct Fragment
+    {
+        std::string           Bytes;
+        bool                  Dirty = true;
+        std::vector<Fragment> Children;
+    };
+
+public:
+    /**
+     * Handle to a node of the document, identified by its path from the root.
+     *
+     * Inserting or removing children changes which node the handles below them point to.
+     */
+    class Node
+    {
+    public:
+        /**
+         * @throws std::out_of_range if the node has no such child.
+         */
+        [[nodiscard]] Node Child(std::size_t index) const
+        {
+            if (index >= Get().Children.size())
+            {
+                throw std::out_of_range("The node has no such child");
+            }
+            Node child = *this;
+            child.m_path.push_back(index);
+            return child;
+        }
+
+        [[nodiscard]] const Tag& Get() const { return *Resolve(false).first; }
+
+        void SetText(std::string_view text) { Resolve(true).first->Text = text; }
+
+        /**
+         * Sets the value of an attribute, adding it if the tag doesn't have it yet.
+         */
+        void SetAttribute(AttributeKey key, std::string_view value)
+        {
+            Tag& tag = *Resolve(true).first;
+            auto it  = std::find_if(tag.Attributes.begin(),
+                                   tag.Attributes.end(),
+                                   [key](const auto& attribute) { return attribute.first == key; });
+            if (it == tag.Attributes.end())
+            {
+                tag.Attributes.emplace_back(key, value);
+            }
+            else
+            {
+                it->second = value;
+            }
+        }
+
+        void RemoveAttribute(AttributeKey key)
+        {
+            Tag& tag = *Resolve(true).first;
+            std::erase_if(tag.Attributes, [key](const auto& attribute) { return attribute.first == key; });
+        }
+
+        void InsertChild(std::size_t index, Tag child)
+        {
+            auto [tag, fragment] = Resolve(true);
+            index                = std::min(index, tag->Children.size());
+            fragment->Children.insert(fragment->Children.begin() + static_cast<std::ptrdiff_t>(index),
+                                      MakeFragment(child));
+            tag->Children.insert(tag->Children.begin() + static_cast<std::ptrdiff_t>(index),
+                                 std::move(child));
+        }
+
+        void AppendChild(Tag child) { InsertChild(Get().Children.size(), std::move(child)); }
+
+        void ReplaceChild(std::size_t index, Tag child)
+        {
+            auto [tag, fragment]   = Resolve(true);
+            fragment->Children.at(index) = MakeFragment(child);
+            tag->Children.at(index)      = std::move(child);
+        }
+
+        void RemoveChild(std::size_t index)
+        {
+            auto [tag, fragment] = Resolve(true);
+            if (index >= tag->Children.size())
+            {
+                throw std::out_of_range("The node has no such child");
+            }
+            fragment->Children.erase(fragment->Children.begin() + static_cast<std::ptrdiff_t>(index));
+            tag->Children.erase(tag->Children.begin() + static_cast<std::ptrdiff_t>(index));
+        }
+
+    private:
+        friend class LiveDocument;
+
+        LiveDocument*            m_document;
+        std::vector<std::size_t> m_path;
+
+        explicit Node(LiveDocument* document) : m_document(document) {}
+
+        /**
+         * Finds the node, optionally marking it and its parents as dirty on the way.
+         */
+        [[nodiscard]] std::pair<Tag*, Fragment*> Resolve(bool markDirty) const
+        {
+            Tag*      tag      = &m_document->m_root;
+            Fragment* fragment = &m_document->m_fragment;
+            for (std::size_t index : m_path)
+            {
+                fragment->Dirty |= markDirty;
+                tag      = &tag->Children.at(index);
+                fragment = &fragment->Children.at(index);
+            }
+            fragment->Dirty |= markDirty;
+            return {tag, fragment};
+        }
+    };
+
+    explicit LiveDocument(Tag root) : m_root(std::move(root)), m_fragment(MakeFragment(m_root)) {}
+
+    // Handles refer to the document, it must not move around.
+    LiveDocument(const LiveDocument&)            = delete;
+    LiveDocument& operator=(const LiveDocument&) = delete;
+
+    [[nodiscard]] Node       Root() { return Node {this}; }
+    [[nodiscard]] const Tag& Get() const { return m_root; }
+
+    /**
+     * Renders the dirty parts of the document.
+     *
+     * @returns The output of the whole document, valid until the next modification.
+     */
+    const std::string& Render(std::size_t indent = 0)
+    {
+        if (indent != m_indent)
+        {
+            // The indentation is part of every cached fragment.
+            m_indent   = indent;
+            m_fragment = MakeFragment(m_root);
+        }
+
+        Refresh(m_root, m_fragment, indent);
+        return m_fragment.Bytes;
+    }
+
+    [[nodiscard]] const FragmentCacheStats& Stats() const { return m_stats; }
+    void                                    ResetStats() { m_stats = {}; }
+
+private:
+    Tag                m_root;
+    Fragment           m_fragment;
+    std::size_t        m_indent = 0;
+    FragmentCacheStats m_stats;
+
+    static Fragment MakeFragment(const Tag& tag)
+    {
+        Fragment fragment;
+        fragment.Children.reserve(tag.Children.size());
+        for (const auto& child : tag.Children)
+        {
+            fragment.Children.push_back(MakeFragment(child));
+        }
+        return fragment;
+    }
+
+    void Refresh(const Tag& tag, Fragment& fragment, std::size_t indent)
+    {
+        if (!fragment.Dirty)
+        {
+            ++m_stats.Hits;
+            return;
+        }
+        ++m_stats.Misses;
+
+        std::size_t childrenSize = 0;
+        for (std::size_t i = 0; i < tag.Children.size(); ++i)
+        {
+            Refresh(tag.Children[i], fragment.Children[i], indent + Tag::IndentSize);
+            childrenSize += fragment.Children[i].Bytes.size();
+        }
+
+        // Generated children have no fragment of their own, they are rendered with their parent.
+        const auto writeGenerated = [&tag, indent](auto& writer)
+        {
+            if (tag.GeneratedChildren != nullptr)
+            {
+                tag.GeneratedChildren->ForEach([&writer, indent](const Tag& child)
+                                               { child.Write(writer, indent + Tag::IndentSize); });
+            }
+        };
+
+        SizeCounter counter;
+        if (tag.WriteOpening(counter, indent))
+        {
+            writeGenerated(counter);
+            tag.WriteClosing(counter, indent);
+        }
+
+        fragment.Bytes.clear();
+        fragment.Bytes.reserve(counter.Size + childrenSize);
+        StringWriter writer {fragment.Bytes};
+        if (tag.WriteOpening(writer, indent))
+        {
+            for (const auto& child : fragment.Children)
+            {
+                writer.Append(child.Bytes);
+            }
+            writeGenerated(writer);
+            tag.WriteClosing(writer, indent);
+        }
+        fragment.Dirty = false;
+    }
+};
+
+#endif    // DESIGN_PATTERNS_LIVE_DOCUMENT_H
@@ -0,0 +1,127 @@
+/**
+ * @file    mapped_file.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Read-only memory mapping of a whole file.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_MAPPED_FILE_H
+#define DESIGN_PATTERNS_MAPPED_FILE_H
+
+#include <cerrno>
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * Maps a whole file in memory, read-only.
+ *
+ * The contents are paged in by the kernel as they are accessed, nothing is copied. Views handed
+ * out by the mapping are valid for as long as it lives.
+ */
+class MappedFile
+{
+public:
+    /**
+     * @throws std::system_error if the file cannot be opened or mapped.
+     */
+    explicit MappedFile(const std::string& path)
+    {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "Unable to open " + path);
+        }
+
+        struct stat info {};
+        if (::fstat(fd, &info) != 0)
+        {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(), "Unable to stat " + path);
+        }
+
+        m_size = static_cast<std::size_t>(info.st_size);
+        if (m_size != 0)
+        {
+            m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (m_data == MAP_FAILED)
+            {
+                const int error = errno;
+                ::close(fd);
+                throw std::system_error(error, std::generic_category(), "Unable to map " + path);
+            }
+            ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+
+        // The mapping stays valid once the descriptor is closed.
+        ::close(fd);
+    }
+
+    MappedFile(const MappedFile&)            = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept
+    : m_data(std::exchange(other.m_data, nullptr)), m_size(std::exchange(other.m_size, 0))
+    {
+    }
+
+    MappedFile& operator=(MappedFile&& other) noexcept
+    {
+        if (this != &other)
+        {
+            Unmap();
+            m_data = std::exchange(other.m_data, nullptr);
+            m_size = std::exchange(other.m_size, 0);
+        }
+        return *this;
+    }
+
+    ~MappedFile() { Unmap(); }
+
+    [[nodiscard]] std::string_view View() const noexcept
+    {
+        return {static_cast<const char*>(m_data), m_size};
+    }
+    [[nodiscard]] const void* data() const noexcept { return m_data; }
+    [[nodiscard]] std::size_t size() const noexcept { return m_size; }
+
+private:
+    void*       m_data = nullptr;
+    std::size_t m_size = 0;
+
+    void Unmap() noexcept
+    {
+        if (m_data != nullptr)
+        {
+            ::munmap(m_data, m_size);
+        }
+    }
+};
+
+#endif    // DESIGN_PATTERNS_MAPPED_FILE_H
@@ -0,0 +1,203 @@
+/**
+ * @file    names.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Tables of the well-known tag names and attribute keys.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_NAMES_H
+#define DESIGN_PATTERNS_NAMES_H
+
+#include <array>
+#include <cstdint>
+#include <string_view>
+
+#include "symbol.h"
+
+/**
+ * Tags that the builder knows about.
+ *
+ * The order must match the one of TagNameTraits::Names.
+ */
+enum class TagId : std::uint16_t
+{
+    Html = 0,
+    Head,
+    Title,
+    Body,
+    H1,
+    H2,
+    H3,
+    H4,
+    H5,
+    H6,
+    P,
+    Br,
+    Hr,
+    Img,
+    Div,
+    Span,
+    Section,
+    Ul,
+    Ol,
+    Li,
+    A,
+    Abbr,
+    Address,
+    B,
+    Bdi,
+    Bdo,
+    Blockquote,
+    Cite,
+    Code,
+    Del,
+    Custom,    //!< Any other tag.
+};
+
+struct TagNameTraits
+{
+    using Id = TagId;
+
+    static constexpr std::array<std::string_view, static_cast<std::size_t>(Id::Custom)> Names = {
+      "html", "head", "title", "body",    "h1",   "h2",         "h3",   "h4",   "h5",  "h6",
+      "p",    "br",   "hr",    "img",     "div",  "span",       "section", "ul", "ol", "li",
+      "a",    "abbr", "address", "b",     "bdi",  "bdo",        "blockquote", "cite", "code", "del",
+    };
+};
+
+/**
+ * Attribute keys that the builder knows about.
+ *
+ * The order must match the one of AttributeKeyTraits::Names.
+ */
+enum class AttributeId : std::uint16_t
+{
+    Lang = 0,
+    Src,
+    Title,
+    Cite,
+    Dir,
+    Id,
+    Class,
+    Href,
+    Alt,
+    Style,
+    Custom,    //!< Any other attribute.
+};
+
+struct AttributeKeyTraits
+{
+    using Id = AttributeId;
+
+    static constexpr std::array<std::string_view, static_cast<std::size_t>(Id::Custom)> Names = {
+      "lang", "src", "title", "cite", "dir", "id", "class", "href", "alt", "style",
+    };
+};
+
+using TagName      = Symbol<TagNameTraits>;
+using AttributeKey = Symbol<AttributeKeyTraits>;
+
+/**
+ * Finds the id of a well-known tag name.
+ *
+ * @returns TagId::Custom if the name is not in the table.
+ */
+constexpr TagId FindTagId(std::string_view name)
+{
+    for (std::size_t i = 0; i < TagNameTraits::Names.size(); ++i)
+    {
+        if (TagNameTraits::Names[i] == name)
+        {
+            return static_cast<TagId>(i);
+        }
+    }
+    return TagId::Custom;
+}
+
+/**
+ * Tells if a tag is a void element, which can never have any content.
+ *
+ * @param name Only looked at when @c id is TagId::Custom.
+ */
+constexpr bool IsVoidElement(TagId id, std::string_view name)
+{
+    switch (id)
+    {
+        case TagId::Br:
+        case TagId::Hr:
+        case TagId::Img: return true;
+        case TagId::Custom:
+        {
+            constexpr std::array<std::string_view, 10> others = {
+              "area", "base", "col", "embed", "input", "link", "meta", "source", "track", "wbr"};
+            for (const auto& other : others)
+            {
+                if (name == other)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+        default: return false;
+    }
+}
+
+constexpr bool IsVoidElement(TagName name)
+{
+    return IsVoidElement(name.GetId(), name.View());
+}
+
+/**
+ * Tells if a tag implicitly closes a paragraph that comes right before it.
+ */
+constexpr bool ClosesParagraph(TagId id)
+{
+    switch (id)
+    {
+        case TagId::Address:
+        case TagId::Blockquote:
+        case TagId::Div:
+        case TagId::H1:
+        case TagId::H2:
+        case TagId::H3:
+        case TagId::H4:
+        case TagId::H5:
+        case TagId::H6:
+        case TagId::Hr:
+        case TagId::Ol:
+        case TagId::P:
+        case TagId::Section:
+        case TagId::Ul: return true;
+        default: return false;
+    }
+}
+
+/**
+ * Tells if the closing tag of a paragraph must be kept when it is the last child of this tag.
+ *
+ * Unknown tags are assumed to require it.
+ */
+constexpr bool KeepsParagraphOpen(TagId parent)
+{
+    return parent == TagId::A || parent == TagId::Del || parent == TagId::Custom;
+}
+
+#endif    // DESIGN_PATTERNS_NAMES_H
@@ -0,0 +1,229 @@
+/**
+ * @file    parallel_renderer.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Renders large documents on several threads.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_PARALLEL_RENDERER_H
+#define DESIGN_PATTERNS_PARALLEL_RENDERER_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "render.h"
+#include "tag.h"
+
+struct ParallelRenderOptions
+{
+    //! Number of threads rendering the document, including the calling one. 0 counts as 1.
+    unsigned int Threads = std::max(std::thread::hardware_concurrency(), 1U);
+    //! Tags with at least that many children have them rendered in parallel.
+    std::size_t MinChildren = 64;
+    //! How deep into the tree to look for tags with enough children.
+    std::size_t MaxDepth = 4;
+    //! Number of partitions made per thread, more partitions balance the load better.
+    std::size_t PartitionsPerThread = 4;
+};
+
+/**
+ * Renders the large lists of children of a document concurrently.
+ *
+ * The top of the tree is split into parts: the opening and closing tags are rendered right away,
+ * while the children of large tags are partitioned into ranges of siblings that are each rendered
+ * into their own buffer by a pool of threads. The parts, put back together in order, are
+ * byte-for-byte identical to the output of Tag::Render.
+ */
+class ParallelRenderer
+{
+public:
+    explicit ParallelRenderer(ParallelRenderOptions options = {}) : m_options(options) {}
+
+    /**
+     * Renders the document into parts that must be written one after the other, with writev for
+     * instance.
+     */
+    [[nodiscard]] std::vector<std::string> RenderParts(const Tag& tag, std::size_t indent = 0) const
+    {
+        std::vector<Part> parts;
+        Plan(tag, indent, 0, parts);
+        Execute(parts);
+
+        std::vector<std::string> out;
+        out.reserve(parts.size());
+        for (auto& part : parts)
+        {
+            out.push_back(std::move(part.Bytes));
+        }
+        return out;
+    }
+
+    [[nodiscard]] std::string Render(const Tag& tag, std::size_t indent = 0) const
+    {
+        const std::vector<std::string> parts = RenderParts(tag, indent);
+
+        std::size_t size = 0;
+        for (const auto& part : parts)
+        {
+            size += part.size();
+        }
+
+        std::string out;
+        out.reserve(size);
+        for (const auto& part : parts)
+        {
+            out += part;
+        }
+        return out;
+    }
+
+private:
+    /**
+     * Either bytes that are already rendered, or a range of siblings left to render.
+     */
+    struct Part
+    {
+        std::string         Bytes;
+        std::span<const Tag> Siblings;
+        std::size_t         Indent = 0;
+    };
+
+    ParallelRenderOptions m_options;
+
+    static std::string& Literal(std::vector<Part>& parts)
+    {
+        if (parts.empty() || !parts.back().Siblings.empty())
+        {
+            parts.emplace_back();
+        }
+        return parts.back().Bytes;
+    }
+
+    void Plan(const Tag& tag, std::size_t indent, std::size_t depth, std::vector<Part>& parts) const
+    {
+        // Generated children only exist one at a time, they can't be split between threads.
+        if (depth >= m_options.MaxDepth || tag.Children.empty() || tag.GeneratedChildren != nullptr)
+        {
+            parts.push_back({{}, std::span {&tag, 1}, indent});
+            return;
+        }
+
+        StringWriter opening {Literal(parts)};
+        tag.WriteOpening(opening, indent);
+
+        const std::span<const Tag> children {tag.Children};
+        const std::size_t          childIndent = indent + Tag::IndentSize;
+        if (children.size() >= m_options.MinChildren)
+        {
+            // No threads at all is taken as the calling one alone.
+            const std::size_t partitions =
+              std::min(children.size(),
+                       std::max(m_options.Threads, 1U) *
+                         std::max<std::size_t>(m_options.PartitionsPerThread, 1));
+            for (std::size_t i = 0; i < partitions; ++i)
+            {
+                const std::size_t begin = children.size() * i / partitions;
+                const std::size_t end   = children.size() * (i + 1) / partitions;
+                parts.push_back({{}, children.subspan(begin, end - begin), childIndent});
+            }
+        }
+        else
+        {
+            for (const auto& child : children)
+            {
+                Plan(child, childIndent, depth + 1, parts);
+            }
+        }
+
+        StringWriter closing {Literal(parts)};
+        tag.WriteClosing(closing, indent);
+    }
+
+    static void RenderPart(Part& part)
+    {
+        SizeCounter counter;
+        for (const auto& tag : part.Siblings)
+        {
+            tag.Write(counter, part.Indent);
+        }
+
+        part.Bytes.resize(counter.Size);
+        BufferWriter writer {part.Bytes.data()};
+        for (const auto& tag : part.Siblings)
+        {
+            tag.Write(writer, part.Indent);
+        }
+    }
+
+    void Execute(std::vector<Part>& parts) const
+    {
+        std::vector<Part*> tasks;
+        for (auto& part : parts)
+        {
+            if (!part.Siblings.empty())
+            {
+                tasks.push_back(&part);
+            }
+        }
+
+        std::atomic<std::size_t> next {0};
+        std::exception_ptr       error;
+        std::mutex               errorMutex;
+        const auto               work = [&]
+        {
+            for (std::size_t i = next++; i < tasks.size(); i = next++)
+            {
+                try
+                {
+                    RenderPart(*tasks[i]);
+                }
+                catch (...)
+                {
+                    std::scoped_lock lock {errorMutex};
+                    error = std::current_exception();
+                }
+            }
+        };
+
+        {
+            const std::size_t         helpers = std::min<std::size_t>(m_options.Threads, tasks.size());
+            std::vector<std::jthread> pool;
+            for (std::size_t i = 1; i < helpers; ++i)
+            {
+                pool.emplace_back(work);
+            }
+            work();
+        }
+
+        if (error)
+        {
+            std::rethrow_exception(error);
+        }
+    }
+};
+
+#endif    // DESIGN_PATTERNS_PARALLEL_RENDERER_H
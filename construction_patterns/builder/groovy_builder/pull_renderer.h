@@ -0,0 +1,209 @@
+/**
+ * @file    pull_renderer.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Renders documents one chunk at a time, on demand.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_PULL_RENDERER_H
+#define DESIGN_PATTERNS_PULL_RENDERER_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "generator.h"
+#include "render.h"
+#include "stream_renderer.h"
+#include "tag.h"
+
+namespace Detail
+{
+/**
+ * Buffer of fixed size in which the output is gathered until there is a full chunk of it.
+ *
+ * Pieces of output that don't fit in what is left of the buffer are kept aside, and poured into
+ * the following chunks.
+ */
+class ChunkBuffer
+{
+public:
+    explicit ChunkBuffer(std::size_t size) : m_buffer(std::max<std::size_t>(size, 1)) {}
+
+    /**
+     * Adds the output of @c write, a callable taking a writer, to the buffer.
+     */
+    template<typename Write>
+    void Put(const Write& write)
+    {
+        SizeCounter counter;
+        write(counter);
+
+        if (counter.Size <= m_buffer.size() - m_used)
+        {
+            BufferWriter writer {m_buffer.data() + m_used};
+            write(writer);
+            m_used += counter.Size;
+            return;
+        }
+
+        m_overflow.resize(counter.Size);
+        BufferWriter writer {m_overflow.data()};
+        write(writer);
+        m_overflowPosition = 0;
+        Pour();
+    }
+
+    [[nodiscard]] bool Full() const { return m_used == m_buffer.size(); }
+    [[nodiscard]] bool Empty() const { return m_used == 0; }
+
+    /**
+     * The chunk gathered so far, valid until Clear() is called.
+     */
+    [[nodiscard]] std::string_view Chunk() const { return {m_buffer.data(), m_used}; }
+
+    /**
+     * Starts a new chunk, with whatever was kept aside.
+     */
+    void Clear()
+    {
+        m_used = 0;
+        Pour();
+    }
+
+private:
+    std::vector<char> m_buffer;
+    std::size_t       m_used = 0;
+    std::string       m_overflow;
+    std::size_t       m_overflowPosition = 0;
+
+    void Pour()
+    {
+        const std::size_t count =
+          std::min(m_overflow.size() - m_overflowPosition, m_buffer.size() - m_used);
+        std::memcpy(m_buffer.data() + m_used, m_overflow.data() + m_overflowPosition, count);
+        m_used += count;
+        m_overflowPosition += count;
+        if (m_overflowPosition == m_overflow.size())
+        {
+            m_overflow.clear();
+            m_overflowPosition = 0;
+        }
+    }
+};
+}    // namespace Detail
+
+/**
+ * Renders @c root one chunk at a time, each time the caller asks for the next one.
+ *
+ * Nothing is rendered until then, so rendering a huge document can be interleaved with other work
+ * and paused for as long as needed, such as while a socket is not ready for more. The coroutine
+ * only keeps the chunk being filled and the path from the root to the tag being written, walked
+ * without recursion.
+ *
+ * @code
+ * auto chunks = RenderChunks(page, 16 * 1024);
+ * while (const std::string_view* chunk = chunks.Next())
+ * {
+ *     Send(*chunk);
+ * }
+ * @endcode
+ *
+ * @param root Must outlive the generator.
+ * @param chunkSize Size of every chunk but the last one.
+ * @returns Chunks that are valid until the generator is resumed.
+ */
+inline Generator<std::string_view> RenderChunks(const Tag& root,
+                                                std::size_t chunkSize = DefaultChunkSize,
+                                                std::size_t indent    = 0)
+{
+    //! A tag whose opening was written, and whose children are being walked.
+    struct Frame
+    {
+        const Tag*                           Node;
+        std::size_t                          Indent;
+        std::size_t                          NextChild = 0;
+        std::unique_ptr<Detail::ChildCursor> Generated;
+    };
+
+    Detail::ChunkBuffer buffer {chunkSize};
+    std::vector<Frame>  stack;
+
+    const auto open = [&buffer, &stack](const Tag& tag, std::size_t tagIndent)
+    {
+        bool opened = false;
+        buffer.Put([&](auto& writer) { opened = tag.WriteOpening(writer, tagIndent); });
+        if (opened)
+        {
+            stack.push_back({&tag, tagIndent, 0, nullptr});
+        }
+    };
+
+    open(root, indent);
+    while (true)
+    {
+        while (buffer.Full())
+        {
+            co_yield buffer.Chunk();
+            buffer.Clear();
+        }
+        if (stack.empty())
+        {
+            break;
+        }
+
+        Frame&     frame = stack.back();
+        const Tag* child = nullptr;
+        if (frame.NextChild < frame.Node->Children.size())
+        {
+            child = &frame.Node->Children[frame.NextChild++];
+        }
+        else if (frame.Node->GeneratedChildren != nullptr)
+        {
+            if (frame.Generated == nullptr)
+            {
+                frame.Generated = frame.Node->GeneratedChildren->Walk();
+            }
+            child = frame.Generated->Next();
+        }
+
+        if (child != nullptr)
+        {
+            open(*child, frame.Indent + Tag::IndentSize);
+        }
+        else
+        {
+            buffer.Put([&frame](auto& writer) { frame.Node->WriteClosing(writer, frame.Indent); });
+            stack.pop_back();
+        }
+    }
+
+    if (!buffer.Empty())
+    {
+        co_yield buffer.Chunk();
+    }
+}
+
+#endif    // DESIGN_PATTERNS_PULL_RENDERER_H
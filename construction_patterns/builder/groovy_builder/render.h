@@ -0,0 +1,220 @@
+/**
+ * @file    render.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Output writers used by the Tag renderer.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_RENDER_H
+#define DESIGN_PATTERNS_RENDER_H
+
+#include <cstddef>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/**
+ * A renderer walks a tag tree and hands its output to a writer, one piece at a time.
+ *
+ * A writer is anything that provides:
+ *  - Append(std::string_view): Outputs the characters as-is.
+ *  - Indent(std::size_t): Outputs that many spaces.
+ *
+ * Rendering a tree twice, once with a SizeCounter and once with a BufferWriter, lets us produce
+ * the whole document into a single allocation.
+ */
+
+/**
+ * Selects how a document is laid out.
+ */
+struct RenderOptions
+{
+    enum class Format
+    {
+        Pretty = 0,    //!< One tag or text per line, indented by nesting level.
+        Minified,      //!< No indentation or line breaks at all.
+    };
+
+    Format Style = Format::Pretty;
+    //! In the minified format, leaves out the closing tags that HTML allows to omit.
+    bool OmitOptionalClosingTags = false;
+    //! In the pretty format, indentation of the root of the document.
+    std::size_t Indent = 0;
+};
+
+/**
+ * The rules of the output format, shared by every renderer so that they all produce the same
+ * bytes.
+ *
+ * An element is written as OpenTag(), then BeginAttribute(), its value and EndAttribute() for each
+ * attribute, then EndOpeningTag(). Unless that completed the element, its text goes between
+ * BeginText() and EndText(), then come its children, at the layout given by Nested(), and finally
+ * CloseTag(). Writing the values and the text is left to the renderers, which store them
+ * differently.
+ */
+namespace Markup
+{
+//! Number of spaces added by each level of nesting in the pretty format.
+inline constexpr std::size_t IndentSize = 4;
+
+/**
+ * Where an element is written.
+ */
+struct Layout
+{
+    bool        Minified = false;
+    std::size_t Indent   = 0;
+
+    //! Layout of the children of an element written with this one.
+    [[nodiscard]] constexpr Layout Nested() const
+    {
+        return Minified ? *this : Layout {false, Indent + IndentSize};
+    }
+};
+
+template<typename Writer>
+constexpr void OpenTag(Writer& writer, std::string_view name, const Layout& layout)
+{
+    if (!layout.Minified)
+    {
+        writer.Indent(layout.Indent);
+    }
+    writer.Append(std::string_view {"<"});
+    writer.Append(name);
+}
+
+template<typename Writer>
+constexpr void BeginAttribute(Writer& writer, std::string_view key)
+{
+    writer.Append(std::string_view {" "});
+    writer.Append(key);
+    writer.Append(std::string_view {"=\""});
+}
+
+template<typename Writer>
+constexpr void EndAttribute(Writer& writer)
+{
+    writer.Append(std::string_view {"\""});
+}
+
+/**
+ * Ends the opening tag of an element.
+ *
+ * Empty elements are self-closing in the pretty format. In the minified one, empty void elements,
+ * such as <br>, have no closing tag, and other empty elements have one, as in <p></p>.
+ *
+ * @param empty Whether the element has neither text nor children.
+ * @param isVoid Whether the element is a void element, only looked at in the minified format.
+ * @returns False if that completed the element, in which case there is nothing else to write.
+ */
+template<typename Writer>
+constexpr bool EndOpeningTag(Writer& writer, const Layout& layout, bool empty, bool isVoid)
+{
+    if (layout.Minified)
+    {
+        writer.Append(std::string_view {">"});
+        return !(empty && isVoid);
+    }
+    if (empty)
+    {
+        writer.Append(std::string_view {"/>\n"});
+        return false;
+    }
+    writer.Append(std::string_view {">\n"});
+    return true;
+}
+
+//! Starts the text of an element written at @c layout, which must not be empty.
+template<typename Writer>
+constexpr void BeginText(Writer& writer, const Layout& layout)
+{
+    if (!layout.Minified)
+    {
+        writer.Indent(layout.Nested().Indent);
+    }
+}
+
+template<typename Writer>
+constexpr void EndText(Writer& writer, const Layout& layout)
+{
+    if (!layout.Minified)
+    {
+        writer.Append(std::string_view {"\n"});
+    }
+}
+
+template<typename Writer>
+constexpr void CloseTag(Writer& writer, std::string_view name, const Layout& layout)
+{
+    if (!layout.Minified)
+    {
+        writer.Indent(layout.Indent);
+    }
+    writer.Append(std::string_view {"</"});
+    writer.Append(name);
+    writer.Append(layout.Minified ? std::string_view {">"} : std::string_view {">\n"});
+}
+}    // namespace Markup
+
+/**
+ * Writer that only counts the number of characters that would be written.
+ */
+struct SizeCounter
+{
+    std::size_t Size = 0;
+
+    void Append(std::string_view str) { Size += str.size(); }
+    void Indent(std::size_t width) { Size += width; }
+};
+
+/**
+ * Writer that outputs into a buffer that is known to be large enough.
+ *
+ * No bound checking is done, the buffer must have been sized with a SizeCounter beforehand.
+ */
+struct BufferWriter
+{
+    char* Cursor = nullptr;
+
+    void Append(std::string_view str)
+    {
+        std::memcpy(Cursor, str.data(), str.size());
+        Cursor += str.size();
+    }
+
+    void Indent(std::size_t width)
+    {
+        std::memset(Cursor, ' ', width);
+        Cursor += width;
+    }
+};
+
+/**
+ * Writer that appends to a string, growing it as needed.
+ */
+struct StringWriter
+{
+    std::string& Out;
+
+    void Append(std::string_view str) { Out.append(str); }
+    void Indent(std::size_t width) { Out.append(width, ' '); }
+};
+
+#endif    // DESIGN_PATTERNS_RENDER_H
@@ -0,0 +1,518 @@
+/**
+ * @file    selector.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   CSS selectors to query Tag trees.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_SELECTOR_H
+#define DESIGN_PATTERNS_SELECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "names.h"
+#include "tag.h"
+
+/**
+ * A CSS selector, made of the following:
+ *  - @c name matches the tags with that name, and @c * any tag;
+ *  - @c [key] matches the tags that have that attribute;
+ *  - @c [key=value] matches the tags whose attribute has that value, which can be quoted;
+ *  - <tt>a b</tt> matches the tags matching @c b that descend from a tag matching @c a;
+ *  - <tt>a > b</tt> matches the tags matching @c b whose parent matches @c a.
+ *
+ * Names are symbols, so matching them is a pointer comparison.
+ *
+ * @code
+ * QueryAll(page, Selector {"section > blockquote[cite='https://example.com']"});
+ * @endcode
+ */
+class Selector
+{
+public:
+    /**
+     * @throws std::invalid_argument if @c text is not a selector, or uses unsupported syntax.
+     */
+    explicit Selector(std::string_view text)
+    {
+        Parser parser {text};
+        m_steps = parser.Parse();
+    }
+
+    /**
+     * Tells if the last tag of @c path matches the selector.
+     *
+     * @param path Every tag from the root of the document down to the one to match.
+     */
+    [[nodiscard]] bool Matches(std::span<const Tag* const> path) const
+    {
+        return !path.empty() && MatchesFrom(path, m_steps.size() - 1, path.size() - 1);
+    }
+
+    /**
+     * Tells if @c tag alone matches the last compound of the selector, ignoring its ancestors.
+     */
+    [[nodiscard]] bool MatchesSubject(const Tag& tag) const { return m_steps.back().Matches(tag); }
+
+    /**
+     * The most selective constraint on the tags the selector matches, used to look them up in an
+     * index.
+     */
+    struct Constraint
+    {
+        std::optional<TagName>      Name;
+        std::optional<AttributeKey> Key;
+        std::optional<std::string>  Value;
+    };
+
+    [[nodiscard]] std::vector<Constraint> SubjectConstraints() const
+    {
+        const Step&             subject = m_steps.back();
+        std::vector<Constraint> out;
+        if (subject.Name)
+        {
+            out.push_back({subject.Name, {}, {}});
+        }
+        for (const auto& test : subject.Attributes)
+        {
+            out.push_back({{}, test.Key, test.Value});
+        }
+        return out;
+    }
+
+private:
+    struct AttributeTest
+    {
+        AttributeKey               Key;
+        std::optional<std::string> Value;
+    };
+
+    //! A compound selector, and how it relates to the previous one.
+    struct Step
+    {
+        bool                       ChildOfPrevious = false;
+        std::optional<TagName>     Name;
+        std::vector<AttributeTest> Attributes;
+
+        [[nodiscard]] bool Matches(const Tag& tag) const
+        {
+            if (Name && tag.Name != *Name)
+            {
+                return false;
+            }
+            return std::ranges::all_of(Attributes,
+                                       [&tag](const AttributeTest& test)
+                                       {
+                                           const auto* value = tag.FindAttribute(test.Key);
+                                           return value != nullptr &&
+                                                  (!test.Value ||
+                                                   std::string_view {*value} == *test.Value);
+                                       });
+        }
+    };
+
+    class Parser
+    {
+    public:
+        explicit Parser(std::string_view text) : m_text(text) {}
+
+        std::vector<Step> Parse()
+        {
+            std::vector<Step> steps;
+            bool              child = false;
+            SkipSpaces();
+            while (true)
+            {
+                Step& step           = steps.emplace_back();
+                step.ChildOfPrevious = child;
+                ParseCompound(step);
+
+                const bool spaced = SkipSpaces();
+                if (m_position == m_text.size())
+                {
+                    return steps;
+                }
+
+                child = m_text[m_position] == '>';
+                if (child)
+                {
+                    ++m_position;
+                    SkipSpaces();
+                }
+                else if (!spaced)
+                {
+                    Fail("Unsupported selector syntax");
+                }
+            }
+        }
+
+    private:
+        std::string_view m_text;
+        std::size_t      m_position = 0;
+
+        [[noreturn]] void Fail(const char* what) const
+        {
+            throw std::invalid_argument(std::string {what} + " at offset " +
+                                        std::to_string(m_position) + " of '" +
+                                        std::string {m_text} + "'");
+        }
+
+        bool SkipSpaces()
+        {
+            const std::size_t start = m_position;
+            while (m_position < m_text.size() &&
+                   (m_text[m_position] == ' ' || m_text[m_position] == '\t' ||
+                    m_text[m_position] == '\n'))
+            {
+                ++m_position;
+            }
+            return m_position != start;
+        }
+
+        static bool IsNameChar(char c)
+        {
+            return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+                   c == '-' || c == '_' || c == ':';
+        }
+
+        std::string_view ReadName()
+        {
+            const std::size_t start = m_position;
+            while (m_position < m_text.size() && IsNameChar(m_text[m_position]))
+            {
+                ++m_position;
+            }
+            return m_text.substr(start, m_position - start);
+        }
+
+        void ParseCompound(Step& step)
+        {
+            if (m_position < m_text.size() && m_text[m_position] == '*')
+            {
+                ++m_position;
+            }
+            else if (const auto name = ReadName(); !name.empty())
+            {
+                step.Name = TagName {name};
+            }
+            else if (m_position >= m_text.size() || m_text[m_position] != '[')
+            {
+                Fail("Expected a tag name or an attribute");
+            }
+
+            while (m_position < m_text.size() && m_text[m_position] == '[')
+            {
+                ++m_position;
+                SkipSpaces();
+                const auto key = ReadName();
+                if (key.empty())
+                {
+                    Fail("Expected an attribute name");
+                }
+                AttributeTest test {AttributeKey {key}, {}};
+
+                SkipSpaces();
+                if (m_position < m_text.size() && m_text[m_position] == '=')
+                {
+                    ++m_position;
+                    SkipSpaces();
+                    test.Value = ReadValue();
+                    SkipSpaces();
+                }
+                if (m_position >= m_text.size() || m_text[m_position] != ']')
+                {
+                    Fail("Expected ']'");
+                }
+                ++m_position;
+                step.Attributes.push_back(std::move(test));
+            }
+        }
+
+        std::string ReadValue()
+        {
+            const char quote = m_position < m_text.size() ? m_text[m_position] : '\0';
+            if (quote == '"' || quote == '\'')
+            {
+                const std::size_t end = m_text.find(quote, m_position + 1);
+                if (end == std::string_view::npos)
+                {
+                    Fail("Unterminated attribute value");
+                }
+                std::string value {m_text.substr(m_position + 1, end - m_position - 1)};
+                m_position = end + 1;
+                return value;
+            }
+
+            // Unlike CSS, unquoted values aren't limited to identifiers, such as a.jpg.
+            const std::size_t start = m_position;
+            while (m_position < m_text.size() && m_text[m_position] != ']' &&
+                   m_text[m_position] != ' ')
+            {
+                ++m_position;
+            }
+            if (m_position == start)
+            {
+                Fail("Expected an attribute value");
+            }
+            return std::string {m_text.substr(start, m_position - start)};
+        }
+    };
+
+    std::vector<Step> m_steps;
+
+    [[nodiscard]] bool MatchesFrom(std::span<const Tag* const> path,
+                                   std::size_t                 step,
+                                   std::size_t                 depth) const
+    {
+        if (!m_steps[step].Matches(*path[depth]))
+        {
+            return false;
+        }
+        if (step == 0)
+        {
+            return true;
+        }
+        if (depth == 0)
+        {
+            return false;
+        }
+
+        if (m_steps[step].ChildOfPrevious)
+        {
+            return MatchesFrom(path, step - 1, depth - 1);
+        }
+        for (std::size_t ancestor = depth; ancestor-- != 0;)
+        {
+            if (MatchesFrom(path, step - 1, ancestor))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * Finds every tag of the tree rooted at @c root that matches @c selector, in document order.
+ *
+ * The whole tree is walked, use a TagIndex to query the same tree repeatedly. Generated children
+ * are not searched, they don't outlive rendering.
+ */
+inline std::vector<const Tag*> QueryAll(const Tag& root, const Selector& selector)
+{
+    struct Frame
+    {
+        const Tag*  Node;
+        std::size_t NextChild = 0;
+    };
+
+    std::vector<const Tag*> out;
+    std::vector<const Tag*> path {&root};
+    std::vector<Frame>      stack {{&root, 0}};
+    if (selector.Matches(path))
+    {
+        out.push_back(&root);
+    }
+
+    while (!stack.empty())
+    {
+        Frame& frame = stack.back();
+        if (frame.NextChild == frame.Node->Children.size())
+        {
+            stack.pop_back();
+            path.pop_back();
+            continue;
+        }
+
+        const Tag& child = frame.Node->Children[frame.NextChild++];
+        path.push_back(&child);
+        if (selector.Matches(path))
+        {
+            out.push_back(&child);
+        }
+        stack.push_back({&child, 0});
+    }
+    return out;
+}
+
+inline std::vector<const Tag*> QueryAll(const Tag& root, std::string_view selector)
+{
+    return QueryAll(root, Selector {selector});
+}
+
+/**
+ * Indexes a tree by tag name, attribute key and attribute value, so that it can be queried without
+ * walking it.
+ *
+ * A query only looks at the tags that have the name or the attribute the selector is the most
+ * selective about, and at their ancestors.
+ *
+ * The index refers to the tags and their attribute values: the tree must outlive the index, and
+ * must not be modified while it is used.
+ */
+class TagIndex
+{
+public:
+    explicit TagIndex(const Tag& root) { Add(root, NoParent); }
+
+    [[nodiscard]] std::size_t NodeCount() const noexcept { return m_nodes.size(); }
+
+    /**
+     * Finds every indexed tag that matches @c selector, in document order.
+     */
+    [[nodiscard]] std::vector<const Tag*> QueryAll(const Selector& selector) const
+    {
+        const std::vector<std::uint32_t>* candidates = nullptr;
+        for (const auto& constraint : selector.SubjectConstraints())
+        {
+            const auto* list = Lookup(constraint);
+            if (list == nullptr)
+            {
+                return {};
+            }
+            if (candidates == nullptr || list->size() < candidates->size())
+            {
+                candidates = list;
+            }
+        }
+
+        std::vector<const Tag*> out;
+        std::vector<const Tag*> path;
+        const auto              check = [&](std::uint32_t id)
+        {
+            const Tag& tag = *m_nodes[id].Node;
+            if (!selector.MatchesSubject(tag))
+            {
+                return;
+            }
+
+            path.clear();
+            for (std::uint32_t node = id; node != NoParent; node = m_nodes[node].Parent)
+            {
+                path.push_back(m_nodes[node].Node);
+            }
+            std::ranges::reverse(path);
+            if (selector.Matches(path))
+            {
+                out.push_back(&tag);
+            }
+        };
+
+        if (candidates == nullptr)
+        {
+            for (std::uint32_t id = 0; id < m_nodes.size(); ++id)
+            {
+                check(id);
+            }
+        }
+        else
+        {
+            std::ranges::for_each(*candidates, check);
+        }
+        return out;
+    }
+
+    [[nodiscard]] std::vector<const Tag*> QueryAll(std::string_view selector) const
+    {
+        return QueryAll(Selector {selector});
+    }
+
+private:
+    static constexpr std::uint32_t NoParent = UINT32_MAX;
+
+    struct Entry
+    {
+        const Tag*    Node;
+        std::uint32_t Parent;
+    };
+
+    using ValueMap = std::unordered_map<std::string_view, std::vector<std::uint32_t>>;
+
+    //! Every tag in document order, so that the lists of ids below are sorted.
+    std::vector<Entry>                                                               m_nodes;
+    std::unordered_map<TagName, std::vector<std::uint32_t>, TagName::Hash>          m_byName;
+    std::unordered_map<AttributeKey, std::vector<std::uint32_t>, AttributeKey::Hash> m_byKey;
+    std::unordered_map<AttributeKey, ValueMap, AttributeKey::Hash>                   m_byValue;
+
+    void Add(const Tag& tag, std::uint32_t parent)
+    {
+        const auto id = static_cast<std::uint32_t>(m_nodes.size());
+        m_nodes.push_back({&tag, parent});
+        m_byName[tag.Name].push_back(id);
+        // A tag carrying the same attribute twice is still listed once, as a walk would find it.
+        for (const auto& [key, value] : tag.Attributes)
+        {
+            AddOnce(m_byKey[key], id);
+            AddOnce(m_byValue[key][std::string_view {value}], id);
+        }
+
+        for (const auto& child : tag.Children)
+        {
+            Add(child, id);
+        }
+    }
+
+    //! Ids are added in increasing order, only the last one can be the same.
+    static void AddOnce(std::vector<std::uint32_t>& ids, std::uint32_t id)
+    {
+        if (ids.empty() || ids.back() != id)
+        {
+            ids.push_back(id);
+        }
+    }
+
+    /**
+     * @returns The ids of the tags satisfying the constraint, or nullptr if there are none.
+     */
+    [[nodiscard]] const std::vector<std::uint32_t>* Lookup(
+      const Selector::Constraint& constraint) const
+    {
+        if (constraint.Name)
+        {
+            const auto it = m_byName.find(*constraint.Name);
+            return it == m_byName.end() ? nullptr : &it->second;
+        }
+        if (!constraint.Value)
+        {
+            const auto it = m_byKey.find(*constraint.Key);
+            return it == m_byKey.end() ? nullptr : &it->second;
+        }
+
+        const auto keyIt = m_byValue.find(*constraint.Key);
+        if (keyIt == m_byValue.end())
+        {
+            return nullptr;
+        }
+        const auto valueIt = keyIt->second.find(*constraint.Value);
+        return valueIt == keyIt->second.end() ? nullptr : &valueIt->second;
+    }
+};
+
+#endif    // DESIGN_PATTERNS_SELECTOR_H
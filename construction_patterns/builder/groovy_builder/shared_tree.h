@@ -0,0 +1,468 @@
+/**
+ * @file    shared_tree.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Immutable tag trees whose identical subtrees are stored only once.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_SHARED_TREE_H
+#define DESIGN_PATTERNS_SHARED_TREE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory_resource>
+#include <mutex>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+
+#include "escape.h"
+#include "names.h"
+#include "render.h"
+#include "tag.h"
+#include "tag_resource.h"
+
+class SharedNode;
+
+/**
+ * Handle to a node of a SubtreeStore.
+ *
+ * Since a store keeps a single copy of each distinct subtree, two handles of the same store are
+ * equal exactly when their subtrees are identical.
+ */
+class SharedTag
+{
+public:
+    SharedTag() = default;
+
+    [[nodiscard]] const SharedNode& operator*() const { return *m_node; }
+    [[nodiscard]] const SharedNode* operator->() const { return m_node; }
+    explicit                        operator bool() const { return m_node != nullptr; }
+
+    friend bool operator==(const SharedTag&, const SharedTag&) = default;
+
+private:
+    friend class SubtreeStore;
+
+    explicit SharedTag(const SharedNode* node) : m_node(node) {}
+
+    const SharedNode* m_node = nullptr;
+};
+
+/**
+ * An immutable tag, owned by a SubtreeStore.
+ *
+ * Its children are handles to other nodes of the store, which any number of parents may share.
+ */
+class SharedNode
+{
+public:
+    using Attribute = Tag::Attribute;
+
+    [[nodiscard]] TagName                    Name() const { return m_name; }
+    [[nodiscard]] std::string_view           Text() const { return m_text; }
+    [[nodiscard]] bool                       RawText() const { return m_rawText; }
+    [[nodiscard]] std::span<const Attribute> Attributes() const { return m_attributes; }
+    [[nodiscard]] std::span<const SharedTag> Children() const { return m_children; }
+
+    //! Hash of the node and of its whole subtree, computed once when the node was stored.
+    [[nodiscard]] std::size_t Hash() const { return m_hash; }
+    //! Number of times the subtree was handed to the store, on its own or as part of another.
+    [[nodiscard]] std::size_t Occurrences() const { return m_occurrences; }
+
+    /**
+     * Builds a regular, mutable Tag tree out of the node and its descendants.
+     */
+    [[nodiscard]] Tag ToTag() const
+    {
+        Tag tag {m_name, m_text};
+        tag.RawText = m_rawText;
+        tag.Attributes.assign(m_attributes.begin(), m_attributes.end());
+        tag.Children.reserve(m_children.size());
+        for (const SharedTag& child : m_children)
+        {
+            tag.Children.push_back(child->ToTag());
+        }
+        return tag;
+    }
+
+    friend bool operator==(const SharedNode& a, const SharedNode& b)
+    {
+        // The children are shared nodes themselves, comparing their handles is enough.
+        return a.m_hash == b.m_hash && a.m_name == b.m_name && a.m_rawText == b.m_rawText &&
+               a.m_text == b.m_text && a.m_attributes == b.m_attributes &&
+               a.m_children == b.m_children;
+    }
+
+private:
+    friend class SubtreeStore;
+
+    using Allocator = std::pmr::polymorphic_allocator<>;
+
+    TagName                     m_name;
+    std::pmr::string            m_text;
+    std::pmr::vector<Attribute> m_attributes;
+    std::pmr::vector<SharedTag> m_children;
+    std::size_t                 m_hash = 0;
+    //! Counted as the store is filled, which never happens concurrently with a read.
+    mutable std::size_t m_occurrences = 1;
+    bool                m_rawText     = false;
+
+    SharedNode(TagName name, std::string_view text, const Allocator& alloc)
+    : m_name(name), m_text(text, alloc), m_attributes(alloc), m_children(alloc)
+    {
+    }
+
+    static std::size_t Combine(std::size_t seed, std::size_t value)
+    {
+        return seed ^ (value + 0x9e3779b97f4a7c15U + (seed << 6U) + (seed >> 2U));
+    }
+
+    void ComputeHash()
+    {
+        const std::hash<std::string_view> hashStr;
+
+        m_hash = Combine(TagName::Hash {}(m_name), hashStr(m_text));
+        m_hash = Combine(m_hash, static_cast<std::size_t>(m_rawText));
+        for (const auto& [key, value] : m_attributes)
+        {
+            m_hash = Combine(m_hash, AttributeKey::Hash {}(key));
+            m_hash = Combine(m_hash, hashStr(value));
+        }
+        for (const SharedTag& child : m_children)
+        {
+            m_hash = Combine(m_hash, child->m_hash);
+        }
+    }
+};
+
+/**
+ * Hash-consing store of immutable tag trees.
+ *
+ * Every distinct subtree is stored exactly once, no matter how many documents contain it: storing
+ * a thousand pages that share their <head> and their footer keeps a single copy of each. Nodes are
+ * looked up by their structural hash, which only has to look at the node itself since its
+ * children have already been stored.
+ *
+ * The rendered text of the subtrees that occur more than once is cached, per layout, the first
+ * time they are rendered, so shared parts of a document are only ever walked once.
+ *
+ * Storing trees is not thread-safe, rendering them is.
+ * @code
+ * SubtreeStore store;
+ * SharedTag    head = store.Intern(Head {Title {"My Site"}});
+ * SharedTag    page = store.Make("html", {head, store.Intern(Body {P {"Page 1"}})});
+ * std::string  html = store.Render(page);
+ * @endcode
+ */
+class SubtreeStore
+{
+public:
+    explicit SubtreeStore(std::pmr::memory_resource* resource = CurrentTagResource())
+    : m_alloc(resource), m_nodes(resource), m_owned(resource), m_fragments(resource)
+    {
+    }
+
+    ~SubtreeStore()
+    {
+        for (SharedNode* node : m_owned)
+        {
+            m_alloc.delete_object(node);
+        }
+    }
+
+    SubtreeStore(const SubtreeStore&)            = delete;
+    SubtreeStore& operator=(const SubtreeStore&) = delete;
+
+    /**
+     * Stores @c tag and its subtree, reusing every part of it that is already in the store.
+     *
+     * Generated children are produced once, and stored like any other child.
+     */
+    SharedTag Intern(const Tag& tag)
+    {
+        SharedNode node {tag.Name, tag.Text, m_alloc};
+        node.m_rawText = tag.RawText;
+        node.m_attributes.assign(tag.Attributes.begin(), tag.Attributes.end());
+        tag.ForEachChild([this, &node](const Tag& child)
+                         { node.m_children.push_back(Intern(child)); });
+        return Add(std::move(node));
+    }
+
+    /**
+     * Stores a tag made of children that are already in the store.
+     *
+     * @throws std::invalid_argument if a child is an empty handle.
+     */
+    SharedTag Make(TagName name, std::span<const SharedTag> children, std::string_view text = {})
+    {
+        SharedNode node {name, text, m_alloc};
+        for (const SharedTag& child : children)
+        {
+            if (!child)
+            {
+                throw std::invalid_argument("Cannot make a tag out of an empty handle");
+            }
+            // Each child occurs once more, as part of this tag.
+            ++child->m_occurrences;
+        }
+        node.m_children.assign(children.begin(), children.end());
+        return Add(std::move(node));
+    }
+
+    SharedTag Make(TagName name, std::initializer_list<SharedTag> children)
+    {
+        return Make(name, std::span {children.begin(), children.size()});
+    }
+
+    //! Number of distinct subtrees in the store.
+    [[nodiscard]] std::size_t UniqueCount() const { return m_owned.size(); }
+
+    //! Number of rendered fragments currently cached.
+    [[nodiscard]] std::size_t FragmentCount() const
+    {
+        std::scoped_lock lock {m_fragmentMutex};
+        return m_fragments.size();
+    }
+
+    /**
+     * Drops every cached fragment.
+     *
+     * Must not be called while a tree of the store is being rendered.
+     */
+    void ClearFragments()
+    {
+        std::scoped_lock lock {m_fragmentMutex};
+        m_fragments.clear();
+    }
+
+    /**
+     * Computes the exact number of characters that rendering @c tag will produce.
+     *
+     * The options are the same as for Tag::Render(), except that the optional closing tags of the
+     * minified format are always written, since whether they can be omitted depends on where a
+     * shared subtree is used.
+     *
+     * @throws std::invalid_argument if OmitOptionalClosingTags is set.
+     */
+    [[nodiscard]] std::size_t RenderedSize(SharedTag tag, const RenderOptions& options = {}) const
+    {
+        SizeCounter counter;
+        Write(counter, tag, options);
+        return counter.Size;
+    }
+
+    void RenderTo(std::string& out, SharedTag tag, const RenderOptions& options = {}) const
+    {
+        const std::size_t offset = out.size();
+        out.resize(offset + RenderedSize(tag, options));
+
+        BufferWriter writer {out.data() + offset};
+        Write(writer, tag, options);
+    }
+
+    [[nodiscard]] std::string Render(SharedTag tag, const RenderOptions& options = {}) const
+    {
+        std::string out;
+        RenderTo(out, tag, options);
+        return out;
+    }
+
+    /**
+     * Walks @c tag and its children, handing the output to @c writer.
+     *
+     * The subtrees whose fragment is cached are written in one piece.
+     *
+     * @tparam Writer See render.h
+     */
+    template<typename Writer>
+    void Write(Writer& writer, SharedTag tag, const RenderOptions& options) const
+    {
+        if (options.OmitOptionalClosingTags)
+        {
+            throw std::invalid_argument("Shared trees always write their closing tags");
+        }
+        if (tag)
+        {
+            // The minified format has no indentation, which lets its fragments be shared by every
+            // level of nesting.
+            const bool minified = options.Style == RenderOptions::Format::Minified;
+            WriteNode(writer, *tag, minified, minified ? 0 : options.Indent);
+        }
+    }
+
+private:
+    struct NodeHash
+    {
+        std::size_t operator()(const SharedNode* node) const { return node->Hash(); }
+    };
+    struct NodeEqual
+    {
+        bool operator()(const SharedNode* a, const SharedNode* b) const { return *a == *b; }
+    };
+
+    //! A fragment depends on the layout it was rendered with.
+    struct FragmentKey
+    {
+        const SharedNode* Node     = nullptr;
+        std::size_t       Indent   = 0;
+        bool              Minified = false;
+
+        friend bool operator==(const FragmentKey&, const FragmentKey&) = default;
+    };
+    struct FragmentKeyHash
+    {
+        std::size_t operator()(const FragmentKey& key) const
+        {
+            return SharedNode::Combine(std::hash<const SharedNode*> {}(key.Node),
+                                       key.Indent * 2 + static_cast<std::size_t>(key.Minified));
+        }
+    };
+
+    SharedNode::Allocator m_alloc;
+    std::pmr::unordered_set<const SharedNode*, NodeHash, NodeEqual> m_nodes;
+    std::pmr::vector<SharedNode*>                                   m_owned;
+
+    mutable std::mutex                                                             m_fragmentMutex;
+    mutable std::pmr::unordered_map<FragmentKey, std::pmr::string, FragmentKeyHash> m_fragments;
+
+    SharedTag Add(SharedNode&& node)
+    {
+        node.ComputeHash();
+        if (const auto it = m_nodes.find(&node); it != m_nodes.end())
+        {
+            ++(*it)->m_occurrences;
+            return SharedTag {*it};
+        }
+
+        m_owned.reserve(m_owned.size() + 1);
+        SharedNode* stored = m_alloc.new_object<SharedNode>(std::move(node));
+        m_owned.push_back(stored);
+        m_nodes.insert(stored);
+        return SharedTag {stored};
+    }
+
+    /**
+     * Leaves are cheaper to write than to look up, only the shared subtrees that have children are
+     * worth caching.
+     */
+    static bool IsCached(const SharedNode& node)
+    {
+        return node.Occurrences() > 1 && !node.Children().empty();
+    }
+
+    template<typename Writer>
+    void WriteNode(Writer& writer, const SharedNode& node, bool minified, std::size_t indent) const
+    {
+        if (IsCached(node))
+        {
+            writer.Append(Fragment(node, minified, indent));
+        }
+        else
+        {
+            WriteUncached(writer, node, minified, indent);
+        }
+    }
+
+    /**
+     * Returns the rendered text of @c node, rendering it if it is not cached yet.
+     *
+     * Two threads may render the same fragment at once, in which case the first one to finish is
+     * kept. The resource of the store doesn't need to be synchronized: it is only used under the lock,
+     * the fragment being rendered into a buffer of its own first.
+     */
+    std::string_view Fragment(const SharedNode& node, bool minified, std::size_t indent) const
+    {
+        const FragmentKey key {&node, indent, minified};
+        {
+            std::scoped_lock lock {m_fragmentMutex};
+            if (const auto it = m_fragments.find(key); it != m_fragments.end())
+            {
+                return it->second;
+            }
+        }
+
+        SizeCounter counter;
+        WriteUncached(counter, node, minified, indent);
+        std::string  fragment(counter.Size, '\0');
+        BufferWriter writer {fragment.data()};
+        WriteUncached(writer, node, minified, indent);
+
+        std::scoped_lock lock {m_fragmentMutex};
+        return m_fragments.try_emplace(key, std::string_view {fragment}).first->second;
+    }
+
+    /**
+     * Writes the node in the same format as Tag::Write(), its children possibly coming from the
+     * cache.
+     */
+    template<typename Writer>
+    void WriteUncached(Writer&           writer,
+                       const SharedNode& node,
+                       bool              minified,
+                       std::size_t       indent) const
+    {
+        const Markup::Layout layout {.Minified = minified, .Indent = indent};
+
+        Markup::OpenTag(writer, node.Name().View(), layout);
+        for (const auto& [key, value] : node.Attributes())
+        {
+            Markup::BeginAttribute(writer, key.View());
+            WriteEscaped(writer, value);
+            Markup::EndAttribute(writer);
+        }
+
+        const bool empty = node.Children().empty() && node.Text().empty();
+        if (!Markup::EndOpeningTag(writer, layout, empty, empty && IsVoidElement(node.Name())))
+        {
+            return;
+        }
+
+        if (!node.Text().empty())
+        {
+            Markup::BeginText(writer, layout);
+            if (node.RawText())
+            {
+                writer.Append(node.Text());
+            }
+            else
+            {
+                WriteEscaped(writer, node.Text());
+            }
+            Markup::EndText(writer, layout);
+        }
+
+        const Markup::Layout nested = layout.Nested();
+        for (const SharedTag& child : node.Children())
+        {
+            WriteNode(writer, *child, nested.Minified, nested.Indent);
+        }
+
+        Markup::CloseTag(writer, node.Name().View(), layout);
+    }
+};
+
+#endif    // DESIGN_PATTERNS_SHARED_TREE_H
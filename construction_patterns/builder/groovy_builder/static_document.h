@@ -0,0 +1,396 @@
+/**
+ * @file    static_document.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Documents rendered at compile time.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_STATIC_DOCUMENT_H
+#define DESIGN_PATTERNS_STATIC_DOCUMENT_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <initializer_list>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+
+#include "escape.h"
+#include "names.h"
+#include "render.h"
+#include "tag.h"
+
+/**
+ * Documents whose structure is known at compile time.
+ *
+ * The tree is built out of constexpr elements and rendered by the compiler, the program only
+ * contains the resulting bytes:
+ *  constexpr auto page = Static::Compile([] {
+ *      return Static::Html(Static::Head(Static::Title("My Page")), Static::Body(...));
+ *  });
+ *  std::cout << page.View();
+ *
+ * Parts of the document that are only known at runtime are left as holes, which are filled when
+ * rendering:
+ *  constexpr auto page = Static::Compile([] {
+ *      return Static::Body(Static::H1(Static::Hole {0}), Static::Img(Static::Hole {1}));
+ *  });
+ *  page.Render(out, {title, url});
+ *
+ * The output is the same as the one of the equivalent Tag tree, except that a hole is always
+ * considered to be non-empty. Like with Tag, strings are escaped unless they are raw, which is done
+ * by the compiler for the static strings and when rendering for the values of the holes.
+ */
+namespace Static
+{
+/**
+ * Placeholder for a string that is provided at runtime.
+ */
+struct Hole
+{
+    std::size_t Index = 0;
+};
+
+/**
+ * Either a string known at compile time, or a hole.
+ */
+struct Content
+{
+    static constexpr std::size_t NoHole = static_cast<std::size_t>(-1);
+
+    std::string_view Str;
+    std::size_t      HoleIndex = NoHole;
+    //! Writes the content as-is instead of escaping it.
+    bool Raw = false;
+
+    constexpr Content() = default;
+    constexpr Content(std::string_view str) : Str(str) {}
+    constexpr Content(const char* str) : Str(str) {}
+    constexpr Content(Hole hole) : HoleIndex(hole.Index) {}
+
+    [[nodiscard]] constexpr bool IsHole() const { return HoleIndex != NoHole; }
+    [[nodiscard]] constexpr bool IsEmpty() const { return !IsHole() && Str.empty(); }
+};
+
+struct Attribute
+{
+    std::string_view Key;
+    Content          Value;
+    //! Leaves the attribute out when its value is empty. A hole is never considered empty.
+    bool OmitEmpty = false;
+
+    [[nodiscard]] constexpr bool IsWritten() const { return !OmitEmpty || !Value.IsEmpty(); }
+};
+
+template<std::size_t AttributeCount, typename... Nodes>
+struct Element
+{
+    std::string_view                      Name;
+    Content                               Text;
+    std::array<Attribute, AttributeCount> Attributes;
+    std::tuple<Nodes...>                  Children;
+
+    template<typename Writer>
+    constexpr void Write(Writer& writer, std::size_t indent) const
+    {
+        const Markup::Layout layout {.Indent = indent};
+
+        Markup::OpenTag(writer, Name, layout);
+        for (const auto& attribute : Attributes)
+        {
+            if (attribute.IsWritten())
+            {
+                Markup::BeginAttribute(writer, attribute.Key);
+                writer.Fill(attribute.Value);
+                Markup::EndAttribute(writer);
+            }
+        }
+
+        if (!Markup::EndOpeningTag(writer, layout, sizeof...(Nodes) == 0 && Text.IsEmpty(), false))
+        {
+            return;
+        }
+
+        if (!Text.IsEmpty())
+        {
+            Markup::BeginText(writer, layout);
+            writer.Fill(Text);
+            Markup::EndText(writer, layout);
+        }
+
+        std::apply([&](const auto&... child) { (child.Write(writer, layout.Nested().Indent), ...); },
+                   Children);
+
+        Markup::CloseTag(writer, Name, layout);
+    }
+};
+
+template<typename T>
+struct IsElement : std::false_type
+{
+};
+
+template<std::size_t AttributeCount, typename... Nodes>
+struct IsElement<Element<AttributeCount, Nodes...>> : std::true_type
+{
+};
+
+template<typename T>
+concept StaticElement = IsElement<std::remove_cvref_t<T>>::value;
+
+/**
+ * Generic element with children.
+ */
+template<StaticElement... Nodes>
+constexpr auto Node(TagName name, Nodes... children)
+{
+    return Element<0, Nodes...> {name.View(), {}, {}, {children...}};
+}
+
+/**
+ * Generic element containing text.
+ */
+constexpr auto Text(TagName name, Content text)
+{
+    return Element<0> {name.View(), text, {}, {}};
+}
+
+template<StaticElement... Nodes>
+constexpr auto Html(Nodes... children)
+{
+    return Element<1, Nodes...> {
+      TagName {TagId::Html}.View(), {}, {{{AttributeKey {AttributeId::Lang}.View(), "en"}}}, {children...}};
+}
+
+// clang-format off
+template<StaticElement... Nodes> constexpr auto Head(Nodes... children) { return Node(TagId::Head, children...); }
+template<StaticElement... Nodes> constexpr auto Body(Nodes... children) { return Node(TagId::Body, children...); }
+template<StaticElement... Nodes> constexpr auto Address(Nodes... children) { return Node(TagId::Address, children...); }
+template<StaticElement... Nodes> constexpr auto P(Nodes... children) { return Node(TagId::P, children...); }
+
+constexpr auto P(Content text) { return Text(TagId::P, text); }
+constexpr auto Title(Content text) { return Text(TagId::Title, text); }
+constexpr auto H1(Content text) { return Text(TagId::H1, text); }
+constexpr auto H2(Content text) { return Text(TagId::H2, text); }
+constexpr auto H3(Content text) { return Text(TagId::H3, text); }
+constexpr auto H4(Content text) { return Text(TagId::H4, text); }
+constexpr auto H5(Content text) { return Text(TagId::H5, text); }
+constexpr auto H6(Content text) { return Text(TagId::H6, text); }
+constexpr auto B(Content text) { return Text(TagId::B, text); }
+constexpr auto Bdi(Content text) { return Text(TagId::Bdi, text); }
+constexpr auto Cite(Content text) { return Text(TagId::Cite, text); }
+constexpr auto Code(Content text) { text.Raw = true; return Text(TagId::Code, text); }
+constexpr auto Del(Content text) { return Text(TagId::Del, text); }
+constexpr auto Br() { return Text(TagId::Br, {}); }
+constexpr auto Hr() { return Text(TagId::Hr, {}); }
+// clang-format on
+
+constexpr auto Img(Content url)
+{
+    return Element<1> {TagName {TagId::Img}.View(), {}, {{{AttributeKey {AttributeId::Src}.View(), url}}}, {}};
+}
+
+constexpr auto Abbr(Content acronym, Content definition)
+{
+    return Element<1> {
+      TagName {TagId::Abbr}.View(), acronym, {{{AttributeKey {AttributeId::Title}.View(), definition}}}, {}};
+}
+
+//! Like the runtime Blockquote, leaves the cite attribute out when there is no source.
+constexpr auto Blockquote(Content text, Content source = {})
+{
+    return Element<1> {TagName {TagId::Blockquote}.View(),
+                       text,
+                       {{{AttributeKey {AttributeId::Cite}.View(), source, true}}},
+                       {}};
+}
+
+/**
+ * Position of a hole in the rendered bytes of a template.
+ */
+struct HoleRef
+{
+    std::size_t Offset = 0;
+    std::size_t Index  = 0;
+    bool        Raw    = false;
+};
+
+/**
+ * The rendered bytes of a static document, and where its holes go.
+ */
+template<std::size_t Size, std::size_t HoleCount>
+struct Template
+{
+    std::array<char, Size>         Bytes {};
+    std::array<HoleRef, HoleCount> Holes {};
+    //! Number of values expected when rendering, one more than the highest hole index.
+    std::size_t ValueCount = 0;
+
+    /**
+     * The whole document, only available when it has no holes.
+     */
+    [[nodiscard]] constexpr std::string_view View() const
+        requires(HoleCount == 0)
+    {
+        return {Bytes.data(), Bytes.size()};
+    }
+
+    /**
+     * Appends the document to @c out, filling its holes with @c values.
+     *
+     * @throws std::out_of_range if fewer values than ValueCount are given.
+     */
+    void Render(std::string& out, std::span<const std::string_view> values) const
+    {
+        if (values.size() < ValueCount)
+        {
+            throw std::out_of_range("Not enough values to fill the holes of the template");
+        }
+
+        // Escaping can only make the values larger, this is only a lower bound.
+        std::size_t size = Bytes.size();
+        for (const auto& hole : Holes)
+        {
+            size += values[hole.Index].size();
+        }
+        out.reserve(out.size() + size);
+
+        StringWriter writer {out};
+        std::size_t  position = 0;
+        for (const auto& hole : Holes)
+        {
+            out.append(Bytes.data() + position, hole.Offset - position);
+            if (hole.Raw)
+            {
+                out.append(values[hole.Index]);
+            }
+            else
+            {
+                WriteEscaped(writer, values[hole.Index]);
+            }
+            position = hole.Offset;
+        }
+        out.append(Bytes.data() + position, Bytes.size() - position);
+    }
+
+    [[nodiscard]] std::string Render(std::initializer_list<std::string_view> values) const
+    {
+        std::string out;
+        Render(out, std::span {values.begin(), values.size()});
+        return out;
+    }
+};
+
+namespace Detail
+{
+struct Measure
+{
+    std::size_t Size       = 0;
+    std::size_t HoleCount  = 0;
+    std::size_t ValueCount = 0;
+
+    constexpr void Append(std::string_view str) { Size += str.size(); }
+    constexpr void Fill(const Content& value)
+    {
+        if (value.IsHole())
+        {
+            ++HoleCount;
+            ValueCount = std::max(ValueCount, value.HoleIndex + 1);
+        }
+        else if (value.Raw)
+        {
+            Size += value.Str.size();
+        }
+        else
+        {
+            WriteEscaped(*this, value.Str);
+        }
+    }
+    constexpr void Indent(std::size_t width) { Size += width; }
+};
+
+template<typename Out>
+struct Emit
+{
+    Out&        Output;
+    std::size_t Position = 0;
+    std::size_t Hole     = 0;
+
+    constexpr void Append(std::string_view str)
+    {
+        for (char c : str)
+        {
+            Output.Bytes[Position++] = c;
+        }
+    }
+    constexpr void Fill(const Content& value)
+    {
+        if (value.IsHole())
+        {
+            Output.Holes[Hole++] = {Position, value.HoleIndex, value.Raw};
+        }
+        else if (value.Raw)
+        {
+            Append(value.Str);
+        }
+        else
+        {
+            WriteEscaped(*this, value.Str);
+        }
+    }
+    constexpr void Indent(std::size_t width)
+    {
+        for (std::size_t i = 0; i < width; ++i)
+        {
+            Output.Bytes[Position++] = ' ';
+        }
+    }
+};
+}    // namespace Detail
+
+/**
+ * Renders the document returned by @c make at compile time.
+ *
+ * @param make Captureless lambda returning the root element of the document.
+ */
+template<typename Make>
+consteval auto Compile(Make /*make*/)
+{
+    constexpr auto document = Make {}();
+    constexpr auto measure  = []
+    {
+        Detail::Measure m;
+        Make {}().Write(m, 0);
+        return m;
+    }();
+
+    Template<measure.Size, measure.HoleCount> out;
+    out.ValueCount = measure.ValueCount;
+    Detail::Emit emit {out};
+    document.Write(emit, 0);
+    return out;
+}
+}    // namespace Static
+
+#endif    // DESIGN_PATTERNS_STATIC_DOCUMENT_H
@@ -0,0 +1,156 @@
+/**
+ * @file    stream_renderer.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Renders documents in fixed-size chunks.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_STREAM_RENDERER_H
+#define DESIGN_PATTERNS_STREAM_RENDERER_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#include <span>
+#include <string_view>
+#include <system_error>
+#include <vector>
+
+#include <unistd.h>
+
+/**
+ * A sink is any callable taking a std::string_view, it receives the rendered document one chunk at
+ * a time. A chunk is only valid for the duration of the call.
+ */
+
+/**
+ * Writer that accumulates the output in a fixed-size buffer, and hands it to a sink each time it
+ * fills up.
+ *
+ * No matter how large the document is, the only memory used for the output is the buffer.
+ */
+template<typename Sink>
+class ChunkWriter
+{
+public:
+    ChunkWriter(Sink& sink, std::span<char> buffer) : m_sink(sink), m_buffer(buffer) {}
+
+    void Append(std::string_view str)
+    {
+        while (!str.empty())
+        {
+            const std::size_t count = std::min(str.size(), m_buffer.size() - m_used);
+            std::memcpy(m_buffer.data() + m_used, str.data(), count);
+            m_used += count;
+            str.remove_prefix(count);
+            FlushIfFull();
+        }
+    }
+
+    void Indent(std::size_t width)
+    {
+        while (width != 0)
+        {
+            const std::size_t count = std::min(width, m_buffer.size() - m_used);
+            std::memset(m_buffer.data() + m_used, ' ', count);
+            m_used += count;
+            width -= count;
+            FlushIfFull();
+        }
+    }
+
+    /**
+     * Hands whatever is left in the buffer to the sink.
+     */
+    void Flush()
+    {
+        if (m_used != 0)
+        {
+            m_sink(std::string_view {m_buffer.data(), m_used});
+            m_used = 0;
+        }
+    }
+
+private:
+    Sink&           m_sink;
+    std::span<char> m_buffer;
+    std::size_t     m_used = 0;
+
+    void FlushIfFull()
+    {
+        if (m_used == m_buffer.size())
+        {
+            Flush();
+        }
+    }
+};
+
+/**
+ * Sink that writes the chunks to a file descriptor, such as a file, a pipe or a socket.
+ *
+ * @throws std::system_error if the descriptor cannot be written to.
+ */
+class FdSink
+{
+public:
+    explicit FdSink(int fd) : m_fd(fd) {}
+
+    void operator()(std::string_view chunk) const
+    {
+        while (!chunk.empty())
+        {
+            const ssize_t written = ::write(m_fd, chunk.data(), chunk.size());
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                throw std::system_error(errno, std::generic_category(), "Unable to write the chunk");
+            }
+            chunk.remove_prefix(static_cast<std::size_t>(written));
+        }
+    }
+
+private:
+    int m_fd;
+};
+
+inline constexpr std::size_t DefaultChunkSize = 64 * 1024;
+
+/**
+ * Renders a document to @c sink, in chunks of at most @c chunkSize characters.
+ *
+ * @tparam Renderable Anything providing Write(writer, indent), such as Tag or FlatView.
+ */
+template<typename Renderable, typename Sink>
+void RenderStream(const Renderable& document,
+                  Sink&&            sink,
+                  std::size_t       chunkSize = DefaultChunkSize,
+                  std::size_t       indent    = 0)
+{
+    std::vector<char> buffer(std::max<std::size_t>(chunkSize, 1));
+    ChunkWriter       writer {sink, std::span {buffer}};
+    document.Write(writer, indent);
+    writer.Flush();
+}
+
+#endif    // DESIGN_PATTERNS_STREAM_RENDERER_H
@@ -0,0 +1,229 @@
+/**
+ * @file    symbol.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Names that are cheap to copy and compare, with compact ids for the well-known ones.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_SYMBOL_H
+#define DESIGN_PATTERNS_SYMBOL_H
+
+#include <atomic>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
+namespace Detail
+{
+/**
+ * Header of the block holding a name that is not known at compile time, followed by its characters.
+ *
+ * The block is shared by every copy of the symbol, and freed with the last one.
+ */
+struct CustomName
+{
+    std::atomic<std::uint32_t> References {1};
+
+    /**
+     * Number of references to custom names taken on this thread, which lets TagArena tell whether
+     * a document it built refers to any.
+     */
+    static std::size_t& TakenOnThisThread()
+    {
+        thread_local std::size_t taken = 0;
+        return taken;
+    }
+
+    static const char* Make(std::string_view str)
+    {
+        ++TakenOnThisThread();
+        void* memory = ::operator new(sizeof(CustomName) + str.size());
+        char* data   = reinterpret_cast<char*>(::new (memory) CustomName + 1);
+        std::memcpy(data, str.data(), str.size());
+        return data;
+    }
+
+    static CustomName* Of(const char* data)
+    {
+        return reinterpret_cast<CustomName*>(const_cast<char*>(data)) - 1;
+    }
+
+    static void Retain(const char* data)
+    {
+        ++TakenOnThisThread();
+        Of(data)->References.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    static void Release(const char* data)
+    {
+        CustomName* name = Of(data);
+        if (name->References.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            name->~CustomName();
+            ::operator delete(name);
+        }
+    }
+};
+}    // namespace Detail
+
+/**
+ * A name that is cheap to copy and compare.
+ *
+ * The strings listed in @c Traits::Names are known at compile time and are referred to by their id,
+ * without any lookup or allocation, and compared by pointer. Any other string is copied into a
+ * block shared by the copies of the symbol, which lives as long as they do: names found in parsed
+ * documents go away with the documents, instead of piling up for the whole program.
+ *
+ * @tparam Traits Provides the enumeration of the well-known strings (@c Id, ending with @c Custom)
+ * and their table (@c Names).
+ */
+template<typename Traits>
+class Symbol
+{
+public:
+    using Id = typename Traits::Id;
+
+    constexpr Symbol(Id id) noexcept
+    : m_data(Traits::Names[static_cast<std::size_t>(id)].data()),
+      m_size(static_cast<std::uint32_t>(Traits::Names[static_cast<std::size_t>(id)].size())),
+      m_id(id)
+    {
+    }
+
+    template<typename String>
+        requires std::convertible_to<const String&, std::string_view>
+    Symbol(const String& str) : Symbol(Lookup(str))
+    {
+    }
+
+    constexpr Symbol(const Symbol& o) noexcept : m_data(o.m_data), m_size(o.m_size), m_id(o.m_id)
+    {
+        if (IsCustom())
+        {
+            Detail::CustomName::Retain(m_data);
+        }
+    }
+    constexpr Symbol& operator=(const Symbol& o) noexcept
+    {
+        if (o.IsCustom())
+        {
+            Detail::CustomName::Retain(o.m_data);
+        }
+        if (IsCustom())
+        {
+            Detail::CustomName::Release(m_data);
+        }
+        m_data = o.m_data;
+        m_size = o.m_size;
+        m_id   = o.m_id;
+        return *this;
+    }
+    constexpr ~Symbol()
+    {
+        if (IsCustom())
+        {
+            Detail::CustomName::Release(m_data);
+        }
+    }
+
+    [[nodiscard]] constexpr std::string_view View() const noexcept { return {m_data, m_size}; }
+    [[nodiscard]] constexpr std::size_t      size() const noexcept { return m_size; }
+    [[nodiscard]] constexpr bool             empty() const noexcept { return m_size == 0; }
+    [[nodiscard]] constexpr const char*      data() const noexcept { return m_data; }
+    //! Id of the symbol, Id::Custom if it is not a well-known string.
+    [[nodiscard]] constexpr Id GetId() const noexcept { return m_id; }
+
+    friend constexpr bool operator==(const Symbol& a, const Symbol& b) noexcept
+    {
+        // Copies of a custom name share their storage, but equal names may have been made apart.
+        return a.m_data == b.m_data || (a.IsCustom() && b.IsCustom() && a.View() == b.View());
+    }
+
+    template<typename String>
+        requires std::convertible_to<const String&, std::string_view>
+    friend constexpr bool operator==(const Symbol& a, const String& b)
+    {
+        return a.View() == std::string_view {b};
+    }
+
+    //! Hashes well-known symbols by id, and the others by content.
+    struct Hash
+    {
+        std::size_t operator()(const Symbol& symbol) const noexcept
+        {
+            return symbol.IsCustom() ? std::hash<std::string_view> {}(symbol.View())
+                                     : static_cast<std::size_t>(symbol.m_id);
+        }
+    };
+
+private:
+    const char*   m_data;
+    std::uint32_t m_size;
+    Id            m_id;
+
+    constexpr Symbol(const char* data, std::uint32_t size, Id id) : m_data(data), m_size(size), m_id(id)
+    {
+    }
+
+    [[nodiscard]] constexpr bool IsCustom() const noexcept { return m_id == Id::Custom; }
+
+    static Symbol Lookup(std::string_view str)
+    {
+        for (std::size_t i = 0; i < Traits::Names.size(); ++i)
+        {
+            if (Traits::Names[i] == str)
+            {
+                return Symbol {static_cast<Id>(i)};
+            }
+        }
+        return Symbol {Detail::CustomName::Make(str), static_cast<std::uint32_t>(str.size()), Id::Custom};
+    }
+};
+
+/**
+ * Makes the symbols of a single document, so that each custom name is only stored once for it.
+ */
+template<typename Traits>
+class SymbolCache
+{
+public:
+    Symbol<Traits> operator()(std::string_view name)
+    {
+        if (const auto it = m_symbols.find(name); it != m_symbols.end())
+        {
+            return it->second;
+        }
+
+        // The key refers to the symbol's own copy of the name, which lives as long as the entry.
+        Symbol<Traits> symbol {name};
+        m_symbols.emplace(symbol.View(), symbol);
+        return symbol;
+    }
+
+private:
+    std::unordered_map<std::string_view, Symbol<Traits>> m_symbols;
+};
+
+#endif    // DESIGN_PATTERNS_SYMBOL_H
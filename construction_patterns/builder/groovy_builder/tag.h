@@ -25,11 +25,39 @@
 #ifndef DESIGN_PATTERNS_TAG_H
 #define DESIGN_PATTERNS_TAG_H
 
-#include <iomanip>
+#include <algorithm>
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <ostream>
+#include <span>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
+#include "child_generator.h"
+#include "escape.h"
+#include "names.h"
+#include "render.h"
+#include "tag_resource.h"
+
+struct Tag;
+
+/**
+ * Satisfied when every argument can be moved (or copied) into a tag's children.
+ *
+ * A single argument of type @c Self is excluded, so that the copy and move constructors of @c Self
+ * are not hijacked by a variadic constructor taking children.
+ */
+template<typename Self, typename... Tags>
+concept ChildTagsOf =
+  (std::derived_from<std::remove_cvref_t<Tags>, Tag> && ...) &&
+  !(sizeof...(Tags) == 1 && (std::same_as<std::remove_cvref_t<Tags>, Self> && ...));
+
 /**
  * Represents an HTML tag.
  *
@@ -38,60 +66,444 @@
  *      Text
  *      <!-- Children -->
  *  </Name>
+ *
+ * The text and the attribute values are escaped when rendered, unless RawText is set.
+ *
+ * Children can also be generated from a view while rendering, in which case each child only exists
+ * while it is being written:
+ * @code
+ * Tag {"ul", rows | std::views::transform([](const Row& row) { return Tag {"li", row.Name}; })};
+ * @endcode
+ *
+ * Tags are allocator-aware: every string and vector of a tag, and of its children, comes from the
+ * memory resource that was current when it was constructed (see tag_resource.h).
  */
 struct Tag
 {
-    using Attribute = std::pair<std::string, std::string>;
+    using allocator_type = std::pmr::polymorphic_allocator<>;
+    using Attribute      = std::pair<AttributeKey, std::pmr::string>;
+
+    //! Number of spaces added to the indentation for each level of nesting.
+    static constexpr std::size_t IndentSize = Markup::IndentSize;
 
     //! Name of the tag.
-    std::string Name;
+    TagName Name;
     //! Text contained in the tag.
-    std::string Text;
+    std::pmr::string Text;
 
-    std::vector<Tag>       Children;
-    std::vector<Attribute> Attributes;
+    std::pmr::vector<Tag>       Children;
+    std::pmr::vector<Attribute> Attributes;
 
-    friend std::ostream& operator<<(std::ostream& os, const Tag& tag)
+    //! Children produced on demand each time the tag is rendered, after those of Children.
+    std::shared_ptr<const Detail::ChildGenerator> GeneratedChildren;
+
+    //! Writes the text as-is instead of escaping it, for content that is already valid HTML.
+    bool RawText = false;
+
+    [[nodiscard]] allocator_type get_allocator() const { return Children.get_allocator(); }
+
+    /**
+     * @returns The value of the attribute, or nullptr if the tag doesn't have it.
+     */
+    [[nodiscard]] const std::pmr::string* FindAttribute(AttributeKey key) const
     {
-        const int width = static_cast<int>(os.width());
-        os << std::setw(width) << ""
-           << "<" << tag.Name;
+        const auto it = std::ranges::find(Attributes, key, &Attribute::first);
+        return it == Attributes.end() ? nullptr : &it->second;
+    }
+
+    [[nodiscard]] bool HasChildren() const
+    {
+        return !Children.empty() || (GeneratedChildren != nullptr && !GeneratedChildren->Empty());
+    }
 
-        for (const auto& attribute : tag.Attributes)
+    /**
+     * Calls @c func with each child, those of Children first, then the generated ones.
+     */
+    template<typename Func>
+    void ForEachChild(Func&& func) const
+    {
+        for (const auto& child : Children)
+        {
+            func(child);
+        }
+        if (GeneratedChildren != nullptr)
+        {
+            GeneratedChildren->ForEach(func);
+        }
+    }
+
+    /**
+     * Computes the exact number of characters that rendering the tag will produce.
+     */
+    [[nodiscard]] std::size_t RenderedSize(std::size_t indent = 0) const
+    {
+        return RenderedSize(RenderOptions {.Indent = indent});
+    }
+
+    [[nodiscard]] std::size_t RenderedSize(const RenderOptions& options) const
+    {
+        SizeCounter counter;
+        Write(counter, options);
+        return counter.Size;
+    }
+
+    /**
+     * Renders the tag into a caller-supplied buffer.
+     *
+     * @returns The number of characters written.
+     * @throws std::length_error if the buffer is too small to hold the tag.
+     */
+    std::size_t RenderTo(std::span<char> out, std::size_t indent = 0) const
+    {
+        return RenderTo(out, RenderOptions {.Indent = indent});
+    }
+
+    std::size_t RenderTo(std::span<char> out, const RenderOptions& options) const
+    {
+        const std::size_t size = RenderedSize(options);
+        if (size > out.size())
         {
-            os << " " << attribute.first << "=\"" << attribute.second << "\"";
+            throw std::length_error("Buffer is too small to render the tag");
         }
 
-        if (tag.Children.empty() && tag.Text.empty())
+        BufferWriter writer {out.data()};
+        Write(writer, options);
+        return size;
+    }
+
+    /**
+     * Renders the tag at the end of @c out, growing it only once.
+     */
+    void RenderTo(std::string& out, std::size_t indent = 0) const
+    {
+        RenderTo(out, RenderOptions {.Indent = indent});
+    }
+
+    void RenderTo(std::string& out, const RenderOptions& options) const
+    {
+        const std::size_t offset = out.size();
+        out.resize(offset + RenderedSize(options));
+
+        BufferWriter writer {out.data() + offset};
+        Write(writer, options);
+    }
+
+    [[nodiscard]] std::string Render(std::size_t indent = 0) const
+    {
+        return Render(RenderOptions {.Indent = indent});
+    }
+
+    [[nodiscard]] std::string Render(const RenderOptions& options) const
+    {
+        std::string out;
+        RenderTo(out, options);
+        return out;
+    }
+
+    template<typename Writer>
+    void Write(Writer& writer, const RenderOptions& options) const
+    {
+        if (options.Style == RenderOptions::Format::Pretty)
         {
-            os << "/>" << std::endl;
+            Write(writer, options.Indent);
         }
         else
         {
-            os << ">" << std::endl;
+            const bool omit = options.OmitOptionalClosingTags;
+            WriteMinified(writer, omit, omit && CanOmitClosingTag(nullptr, nullptr));
+        }
+    }
 
-            if (!tag.Text.empty())
-            {
-                os << std::setw((width + 4)) << "" << tag.Text << std::endl;
-            }
+    /**
+     * Walks the tag and its children, handing the output to @c writer.
+     *
+     * @tparam Writer See render.h
+     */
+    template<typename Writer>
+    void Write(Writer& writer, std::size_t indent) const
+    {
+        if (!WriteOpening(writer, indent))
+        {
+            return;
+        }
 
-            for (const auto& child : tag.Children)
-            {
-                os << std::setw(width + 4) << child;
-            }
+        ForEachChild([&writer, indent](const Tag& child) { child.Write(writer, indent + IndentSize); });
+
+        WriteClosing(writer, indent);
+    }
+
+    /**
+     * Writes the opening tag, its attributes and the text, but not the children.
+     *
+     * @returns False if the tag was self-closing, in which case there is nothing else to write.
+     */
+    template<typename Writer>
+    bool WriteOpening(Writer& writer, std::size_t indent) const
+    {
+        return WriteOpening(writer, Markup::Layout {.Indent = indent});
+    }
+
+    template<typename Writer>
+    void WriteClosing(Writer& writer, std::size_t indent) const
+    {
+        Markup::CloseTag(writer, Name.View(), Markup::Layout {.Indent = indent});
+    }
+
+    /**
+     * Walks the tag and its children without any indentation or line break.
+     *
+     * Empty void elements, such as <br>, are written without a closing tag, and other empty
+     * elements with one, as in <p></p>.
+     *
+     * @param omitClosingTags Leaves out the closing tags of the children that HTML lets us omit.
+     * @param omitClosing Leaves out the closing tag of this tag.
+     */
+    template<typename Writer>
+    void WriteMinified(Writer& writer, bool omitClosingTags, bool omitClosing = false) const
+    {
+        if (WriteMinifiedOpening(writer, omitClosingTags) && !omitClosing)
+        {
+            WriteMinifiedClosing(writer, Name);
+        }
+    }
+
+    /**
+     * Writes everything WriteMinified() does, except for the closing tag.
+     *
+     * @returns False if the tag is an empty void element, which never has a closing tag.
+     */
+    template<typename Writer>
+    bool WriteMinifiedOpening(Writer& writer, bool omitClosingTags) const
+    {
+        if (!WriteOpening(writer, Markup::Layout {.Minified = true}))
+        {
+            return false;
+        }
+
+        // Whether the closing tag of a child can be omitted depends on the next one, so it is only
+        // written once that one is known.
+        std::optional<TagName> unclosed;
+        ForEachChild(
+          [&](const Tag& child)
+          {
+              if (unclosed && !(omitClosingTags && CanOmitClosingTag(unclosed->GetId(), &child, this)))
+              {
+                  WriteMinifiedClosing(writer, *unclosed);
+              }
+              unclosed.reset();
+              if (child.WriteMinifiedOpening(writer, omitClosingTags))
+              {
+                  unclosed = child.Name;
+              }
+          });
+        if (unclosed && !(omitClosingTags && CanOmitClosingTag(unclosed->GetId(), nullptr, this)))
+        {
+            WriteMinifiedClosing(writer, *unclosed);
+        }
+        return true;
+    }
+
+    template<typename Writer>
+    static void WriteMinifiedClosing(Writer& writer, TagName name)
+    {
+        Markup::CloseTag(writer, name.View(), Markup::Layout {.Minified = true});
+    }
+
+    /**
+     * Writes the opening tag, its attributes and the text, but not the children.
+     *
+     * @returns False if that completed the tag, in which case there is nothing else to write.
+     */
+    template<typename Writer>
+    bool WriteOpening(Writer& writer, const Markup::Layout& layout) const
+    {
+        Markup::OpenTag(writer, Name.View(), layout);
+        WriteAttributes(writer);
+
+        const bool empty = !HasChildren() && Text.empty();
+        if (!Markup::EndOpeningTag(writer, layout, empty, empty && IsVoidElement(Name)))
+        {
+            return false;
+        }
+
+        if (!Text.empty())
+        {
+            Markup::BeginText(writer, layout);
+            WriteText(writer);
+            Markup::EndText(writer, layout);
+        }
+        return true;
+    }
+
+    /**
+     * Tells if HTML allows the closing tag of this tag to be left out.
+     *
+     * Only the tags known to be safe are considered, any other tag keeps its closing tag.
+     *
+     * @param next Sibling following the tag, nullptr if it is the last one.
+     * @param parent Parent of the tag, nullptr if it is the root.
+     */
+    [[nodiscard]] bool CanOmitClosingTag(const Tag* next, const Tag* parent) const
+    {
+        return CanOmitClosingTag(Name.GetId(), next, parent);
+    }
+
+    [[nodiscard]] static bool CanOmitClosingTag(TagId id, const Tag* next, const Tag* parent)
+    {
+        switch (id)
+        {
+            case TagId::Html:
+            case TagId::Head:
+            case TagId::Body: return true;
+            case TagId::Li: return next == nullptr || next->Name.GetId() == TagId::Li;
+            case TagId::P:
+                if (next != nullptr)
+                {
+                    return ClosesParagraph(next->Name.GetId());
+                }
+                return parent != nullptr && !KeepsParagraphOpen(parent->Name.GetId());
+            default: return false;
+        }
+    }
+
+    template<typename Writer>
+    void WriteAttributes(Writer& writer) const
+    {
+        for (const auto& attribute : Attributes)
+        {
+            Markup::BeginAttribute(writer, attribute.first.View());
+            WriteEscaped(writer, attribute.second);
+            Markup::EndAttribute(writer);
+        }
+    }
 
-            os << std::setw(width) << ""
-               << "</" << tag.Name << ">" << std::endl;
+    template<typename Writer>
+    void WriteText(Writer& writer) const
+    {
+        if (RawText)
+        {
+            writer.Append(Text);
         }
+        else
+        {
+            WriteEscaped(writer, Text);
+        }
+    }
 
-        return os;
+    friend std::ostream& operator<<(std::ostream& os, const Tag& tag)
+    {
+        // The width of the stream is used as the indentation of the tag.
+        const auto        width    = std::max<std::streamsize>(os.width(0), 0);
+        const std::string rendered = tag.Render(static_cast<std::size_t>(width));
+        return os.write(rendered.data(), static_cast<std::streamsize>(rendered.size()));
     }
 
+#ifdef GROOVY_BUILDER_COUNT_COPIES
+    //! Number of times a tag has been deep-copied, used to benchmark the construction of trees.
+    static inline std::size_t CopyCount = 0;
+#endif
+
+    // Copies are made with the current resource rather than the one of the original tag.
+    Tag(const Tag& o) : Tag(o, allocator_type {CurrentTagResource()}) {}
+    Tag(const Tag& o, const allocator_type& alloc)
+    : Name(o.Name),
+      Text(o.Text, alloc),
+      Children(o.Children, alloc),
+      Attributes(o.Attributes, alloc),
+      GeneratedChildren(o.GeneratedChildren),
+      RawText(o.RawText)
+    {
+        if (GeneratedChildren != nullptr)
+        {
+            ++Detail::ChildGenerator::SharedOnThisThread();
+        }
+#ifdef GROOVY_BUILDER_COUNT_COPIES
+        ++CopyCount;
+#endif
+    }
+    Tag(Tag&&) noexcept = default;
+    // Only moves the members if they already use @c alloc, copies them otherwise.
+    Tag(Tag&& o, const allocator_type& alloc)
+    : Name(o.Name),
+      Text(std::move(o.Text), alloc),
+      Children(std::move(o.Children), alloc),
+      Attributes(std::move(o.Attributes), alloc),
+      GeneratedChildren(std::move(o.GeneratedChildren)),
+      RawText(o.RawText)
+    {
+    }
+    Tag& operator=(const Tag& o)
+    {
+        if (this != &o)
+        {
+#ifdef GROOVY_BUILDER_COUNT_COPIES
+            ++CopyCount;
+#endif
+            Name              = o.Name;
+            Text              = o.Text;
+            Children          = o.Children;
+            Attributes        = o.Attributes;
+            GeneratedChildren = o.GeneratedChildren;
+            RawText           = o.RawText;
+            if (GeneratedChildren != nullptr)
+            {
+                ++Detail::ChildGenerator::SharedOnThisThread();
+            }
+        }
+        return *this;
+    }
+    Tag& operator=(Tag&&) noexcept = default;
+    ~Tag()                         = default;
+
 protected:
+    /**
+     * Moves each child into a vector, without ever copying them.
+     *
+     * Unlike a std::initializer_list, whose elements are const, this lets a whole tree be built
+     * with one move per node, no matter how deep it is.
+     */
+    template<typename... Tags>
+    static std::pmr::vector<Tag> MakeChildren(Tags&&... children)
+    {
+        std::pmr::vector<Tag> out {allocator_type {CurrentTagResource()}};
+        out.reserve(sizeof...(children));
+        (out.emplace_back(std::forward<Tags>(children)), ...);
+        return out;
+    }
+
 public:
-    Tag(std::string name, std::string text) : Name(std::move(name)), Text(std::move(text)) {}
-    Tag(std::string name, std::vector<Tag> children)
-    : Name(std::move(name)), Children(std::move(children))
+    Tag(TagName name, std::string_view text)
+    : Tag(name, allocator_type {CurrentTagResource()})
+    {
+        Text = text;
+    }
+    Tag(TagName name, std::pmr::vector<Tag> children)
+    : Tag(name, allocator_type {CurrentTagResource()})
+    {
+        Children = std::move(children);
+    }
+    template<typename... Tags>
+        requires ChildTagsOf<Tag, Tags...>
+    Tag(TagName name, Tags&&... children)
+    : Tag(name, MakeChildren(std::forward<Tags>(children)...))
+    {
+    }
+    /**
+     * Creates a tag whose children are generated from @c children each time it is rendered.
+     *
+     * The view is kept by the tag, along with whatever it refers to: a container turned into a view
+     * with std::views::all must outlive the tag.
+     */
+    template<typename View>
+        requires ChildTagView<View>
+    Tag(TagName name, View&& children) : Tag(name, allocator_type {CurrentTagResource()})
+    {
+        GeneratedChildren = Detail::MakeChildGenerator(std::forward<View>(children));
+    }
+
+private:
+    Tag(TagName name, const allocator_type& alloc)
+    : Name(name), Text(alloc), Children(alloc), Attributes(alloc)
     {
     }
 };
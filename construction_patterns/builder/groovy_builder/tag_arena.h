@@ -0,0 +1,171 @@
+/**
+ * @file    tag_arena.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Allocates whole tag documents from a single arena.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_TAG_ARENA_H
+#define DESIGN_PATTERNS_TAG_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <memory_resource>
+#include <new>
+#include <utility>
+
+#include "tag.h"
+#include "tag_resource.h"
+
+/**
+ * Memory resource that counts the allocations made through it before forwarding them upstream.
+ */
+class CountingResource : public std::pmr::memory_resource
+{
+public:
+    explicit CountingResource(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+    : m_upstream(upstream)
+    {
+    }
+
+    [[nodiscard]] std::size_t Allocations() const { return m_allocations; }
+    [[nodiscard]] std::size_t Deallocations() const { return m_deallocations; }
+    [[nodiscard]] std::size_t BytesAllocated() const { return m_bytesAllocated; }
+    //! Highest number of bytes allocated and not yet deallocated at any one time.
+    [[nodiscard]] std::size_t PeakBytesInUse() const { return m_peakBytesInUse; }
+
+    void ResetCounters()
+    {
+        m_allocations    = 0;
+        m_deallocations  = 0;
+        m_bytesAllocated = 0;
+        m_peakBytesInUse = m_bytesInUse;
+    }
+
+private:
+    std::pmr::memory_resource* m_upstream;
+
+    std::size_t m_allocations    = 0;
+    std::size_t m_deallocations  = 0;
+    std::size_t m_bytesAllocated = 0;
+    std::size_t m_bytesInUse     = 0;
+    std::size_t m_peakBytesInUse = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_allocations;
+        m_bytesAllocated += bytes;
+        m_bytesInUse += bytes;
+        m_peakBytesInUse = std::max(m_peakBytesInUse, m_bytesInUse);
+        return m_upstream->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override
+    {
+        ++m_deallocations;
+        m_bytesInUse -= bytes;
+        m_upstream->deallocate(p, bytes, alignment);
+    }
+
+    [[nodiscard]] bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override
+    {
+        return this == &other;
+    }
+};
+
+/**
+ * Owns a document whose every node, string and vector is allocated from a monotonic arena.
+ *
+ * The document's memory is never freed node by node: Reset() hands the arena's memory back in one
+ * go, which makes it cheap to build one document per request and throw it away:
+ *  TagArena arena;
+ *  const Tag& page = arena.Build([] { return Html { Body { P {"Some text"} } }; });
+ *  send(page.Render());
+ *  arena.Reset();
+ *
+ * Only documents that refer to something living outside of the arena, custom names or generated
+ * children, are destroyed tag by tag, so that these get released. Build() tells them apart by the
+ * references taken while the document is made: a document given any afterwards is not released
+ * properly, it should be rebuilt instead.
+ */
+class TagArena
+{
+public:
+    static constexpr std::size_t DefaultInitialSize = 64 * 1024;
+
+    explicit TagArena(std::size_t                initialSize = DefaultInitialSize,
+                      std::pmr::memory_resource* upstream    = std::pmr::get_default_resource())
+    : m_resource(initialSize, upstream)
+    {
+    }
+
+    ~TagArena() { Reset(); }
+
+    TagArena(const TagArena&)            = delete;
+    TagArena& operator=(const TagArena&) = delete;
+
+    /**
+     * Builds a document in the arena, replacing the previous one.
+     *
+     * @param make Callable returning the root of the document. Every tag it constructs is
+     * allocated from the arena.
+     */
+    template<typename Func>
+    Tag& Build(Func&& make)
+    {
+        Reset();
+
+        const std::size_t names      = Detail::CustomName::TakenOnThisThread();
+        const std::size_t generators = Detail::ChildGenerator::SharedOnThisThread();
+
+        ScopedTagResource scope {&m_resource};
+        void*             memory = m_resource.allocate(sizeof(Tag), alignof(Tag));
+        m_root                   = ::new (memory) Tag(std::forward<Func>(make)());
+        m_refersOutside          = Detail::CustomName::TakenOnThisThread() != names ||
+                                   Detail::ChildGenerator::SharedOnThisThread() != generators;
+        return *m_root;
+    }
+
+    [[nodiscard]] Tag*                       Root() const { return m_root; }
+    [[nodiscard]] std::pmr::memory_resource* Resource() { return &m_resource; }
+
+    /**
+     * Releases the document and all the memory it used, in constant time unless the document
+     * refers to something outside of the arena.
+     */
+    void Reset()
+    {
+        if (std::exchange(m_refersOutside, false))
+        {
+            std::destroy_at(m_root);
+        }
+        m_root = nullptr;
+        m_resource.release();
+    }
+
+private:
+    std::pmr::monotonic_buffer_resource m_resource;
+    Tag*                                m_root = nullptr;
+    //! Whether the tags of the document must be destroyed to release what they refer to.
+    bool                                m_refersOutside = false;
+};
+
+#endif    // DESIGN_PATTERNS_TAG_ARENA_H
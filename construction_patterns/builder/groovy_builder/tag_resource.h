@@ -0,0 +1,76 @@
+/**
+ * @file    tag_resource.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Selects the memory resource that new tags allocate from.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+#ifndef DESIGN_PATTERNS_TAG_RESOURCE_H
+#define DESIGN_PATTERNS_TAG_RESOURCE_H
+
+#include <memory_resource>
+
+namespace Detail
+{
+inline std::pmr::memory_resource*& CurrentTagResourceSlot()
+{
+    thread_local std::pmr::memory_resource* resource = nullptr;
+    return resource;
+}
+}    // namespace Detail
+
+/**
+ * Memory resource used by the tags constructed on this thread.
+ *
+ * Falls back on the default resource of the program when no ScopedTagResource is active.
+ */
+inline std::pmr::memory_resource* CurrentTagResource()
+{
+    std::pmr::memory_resource* resource = Detail::CurrentTagResourceSlot();
+    return resource != nullptr ? resource : std::pmr::get_default_resource();
+}
+
+/**
+ * Makes every tag constructed on this thread allocate from @c resource, for as long as it lives.
+ *
+ * This lets the nested tag syntax allocate a whole document from an arena without having to hand
+ * an allocator to each and every tag:
+ *  ScopedTagResource scope {&arena};
+ *  Tag page = Html { Body { P {"Some text"} } };
+ */
+class ScopedTagResource
+{
+public:
+    explicit ScopedTagResource(std::pmr::memory_resource* resource)
+    : m_previous(Detail::CurrentTagResourceSlot())
+    {
+        Detail::CurrentTagResourceSlot() = resource;
+    }
+
+    ~ScopedTagResource() { Detail::CurrentTagResourceSlot() = m_previous; }
+
+    ScopedTagResource(const ScopedTagResource&)            = delete;
+    ScopedTagResource& operator=(const ScopedTagResource&) = delete;
+
+private:
+    std::pmr::memory_resource* m_previous;
+};
+
+#endif    // DESIGN_PATTERNS_TAG_RESOURCE_H
@@ -29,5 +29,6 @@
 
 #include "basic/basic.h"
 #include "formatting/formatting.h"
+#include "lists/lists.h"
 
 #endif    // DESIGN_PATTERNS_TAGS_H
@@ -0,0 +1,665 @@
+/**
+ * @file    tree_diff.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Differences between two tag trees, as a patch that can be sent over the wire.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_TREE_DIFF_H
+#define DESIGN_PATTERNS_TREE_DIFF_H
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include "names.h"
+#include "tag.h"
+
+/**
+ * A single change made to a tag tree.
+ *
+ * A node is designated by its path: the index of each of its ancestors' child, starting from the
+ * root. The root itself has an empty path. Paths refer to the tree as it is once every previous
+ * operation of the patch has been applied.
+ */
+struct PatchOperation
+{
+    //! The value of each kind is the character that starts it in a serialized patch.
+    enum class Kind : char
+    {
+        Insert          = '+',    //!< Inserts Subtree so that it ends up at Path.
+        Remove          = '-',    //!< Removes the node at Path.
+        Replace         = '*',    //!< Replaces the node at Path by Subtree.
+        Move            = '>',    //!< Takes the child From of the parent, then inserts it at Path.
+        ReplaceText     = '~',    //!< Sets the text of the node at Path to Value.
+        SetAttribute    = '=',    //!< Sets the attribute Key of the node at Path to Value.
+        RemoveAttribute = '!',    //!< Removes the attribute Key from the node at Path.
+    };
+
+    Kind                       Type = Kind::Remove;
+    std::vector<std::uint32_t> Path;
+    std::uint32_t              From = 0;
+    std::string                Key;
+    std::string                Value;
+    std::optional<Tag>         Subtree;
+};
+
+/**
+ * Selects how the children of two tags are paired up.
+ */
+struct DiffOptions
+{
+    /**
+     * Pairs up the children that have the same id attribute, wherever they are, and moves them
+     * rather than re-sending them. The other children are paired up by position.
+     */
+    bool MatchById = false;
+};
+
+namespace Detail
+{
+/**
+ * Walks two trees side by side, collecting the operations that turn the first into the second.
+ */
+class TreeDiffer
+{
+public:
+    TreeDiffer(const DiffOptions& options, std::vector<PatchOperation>& out)
+    : m_options(options), m_out(out)
+    {
+    }
+
+    //! Diffs two nodes that sit at the same place, @c m_path.
+    void DiffMatched(const Tag& before, const Tag& after)
+    {
+        if (before.Name != after.Name || before.RawText != after.RawText)
+        {
+            Emit(PatchOperation::Kind::Replace).Subtree.emplace(after);
+            return;
+        }
+        if (before.GeneratedChildren != nullptr || after.GeneratedChildren != nullptr)
+        {
+            throw std::invalid_argument("Cannot diff the generated children of a tag");
+        }
+
+        if (before.Text != after.Text)
+        {
+            Emit(PatchOperation::Kind::ReplaceText).Value = after.Text;
+        }
+        DiffAttributes(before, after);
+        DiffChildren(before, after);
+    }
+
+private:
+    static constexpr std::uint32_t Inserted = UINT32_MAX;
+
+    const DiffOptions&           m_options;
+    std::vector<PatchOperation>& m_out;
+    std::vector<std::uint32_t>   m_path;
+
+    PatchOperation& Emit(PatchOperation::Kind kind)
+    {
+        PatchOperation& op = m_out.emplace_back();
+        op.Type            = kind;
+        op.Path            = m_path;
+        return op;
+    }
+
+    /**
+     * Attributes are written in order, which a new attribute being appended must not change: once
+     * the order of the two tags differs, the remaining attributes are all removed and set again.
+     */
+    void DiffAttributes(const Tag& before, const Tag& after)
+    {
+        std::vector<const Tag::Attribute*> kept;
+        for (const auto& attribute : before.Attributes)
+        {
+            if (after.FindAttribute(attribute.first) == nullptr)
+            {
+                Emit(PatchOperation::Kind::RemoveAttribute).Key = attribute.first.View();
+            }
+            else
+            {
+                kept.push_back(&attribute);
+            }
+        }
+
+        std::size_t i = 0;
+        for (; i < after.Attributes.size() && i < kept.size(); ++i)
+        {
+            const auto& [key, value] = after.Attributes[i];
+            if (kept[i]->first != key)
+            {
+                break;
+            }
+            if (kept[i]->second != value)
+            {
+                EmitSetAttribute(key, value);
+            }
+        }
+        for (std::size_t j = i; j < kept.size(); ++j)
+        {
+            Emit(PatchOperation::Kind::RemoveAttribute).Key = kept[j]->first.View();
+        }
+        for (; i < after.Attributes.size(); ++i)
+        {
+            EmitSetAttribute(after.Attributes[i].first, after.Attributes[i].second);
+        }
+    }
+
+    void EmitSetAttribute(AttributeKey key, std::string_view value)
+    {
+        PatchOperation& op = Emit(PatchOperation::Kind::SetAttribute);
+        op.Key             = key.View();
+        op.Value           = value;
+    }
+
+    [[nodiscard]] const std::pmr::string* KeyOf(const Tag& tag) const
+    {
+        return m_options.MatchById ? tag.FindAttribute(AttributeId::Id) : nullptr;
+    }
+
+    /**
+     * Pairs up the children in a single pass over the new ones, keeping track of where each old
+     * child currently is.
+     *
+     * The old children whose id is not used anymore are removed. Then, a new child is paired with
+     * the old child that has the same id, which is moved in place if needed. Failing that, it is
+     * paired with the old child at its position, unless that one is waiting for its own id to come
+     * up, in which case the new child is inserted. The old children left over at the end are
+     * removed.
+     */
+    void DiffChildren(const Tag& before, const Tag& after)
+    {
+        const auto& previous = before.Children;
+        const auto& next     = after.Children;
+
+        // Old children that have the id of a new one, by id.
+        std::unordered_map<std::string_view, std::uint32_t> keyed;
+        std::vector<bool>                                    isKeyed(previous.size(), false);
+        if (m_options.MatchById)
+        {
+            std::unordered_set<std::string_view> ids;
+            for (const Tag& child : next)
+            {
+                if (const auto* id = KeyOf(child))
+                {
+                    ids.insert(*id);
+                }
+            }
+            for (std::uint32_t i = 0; i < previous.size(); ++i)
+            {
+                const auto* id = KeyOf(previous[i]);
+                if (id != nullptr && ids.contains(*id) && keyed.try_emplace(*id, i).second)
+                {
+                    isKeyed[i] = true;
+                }
+            }
+        }
+
+        std::vector<std::uint32_t> current(previous.size());
+        for (std::uint32_t i = 0; i < current.size(); ++i)
+        {
+            current[i] = i;
+        }
+
+        // The old children whose id is gone are removed first, so that removing one doesn't shift
+        // all of those after it away from their new position.
+        if (m_options.MatchById)
+        {
+            for (auto i = previous.size(); i > 0; --i)
+            {
+                if (!isKeyed[i - 1] && KeyOf(previous[i - 1]) != nullptr)
+                {
+                    m_path.push_back(static_cast<std::uint32_t>(i - 1));
+                    Emit(PatchOperation::Kind::Remove);
+                    m_path.pop_back();
+                    current.erase(current.begin() + static_cast<std::ptrdiff_t>(i - 1));
+                }
+            }
+        }
+
+        for (std::uint32_t j = 0; j < next.size(); ++j)
+        {
+            m_path.push_back(j);
+            const Tag& child = next[j];
+
+            auto match = keyed.end();
+            if (const auto* id = KeyOf(child))
+            {
+                match = keyed.find(*id);
+            }
+
+            if (match != keyed.end() && match->second != Inserted)
+            {
+                const std::uint32_t old = std::exchange(match->second, Inserted);
+                const auto          at  = std::find(current.begin() + j, current.end(), old);
+                if (at != current.begin() + j)
+                {
+                    Emit(PatchOperation::Kind::Move).From =
+                      static_cast<std::uint32_t>(at - current.begin());
+                    current.erase(at);
+                    current.insert(current.begin() + j, old);
+                }
+                DiffMatched(previous[old], child);
+            }
+            else if (j < current.size() && !isKeyed[current[j]])
+            {
+                DiffMatched(previous[current[j]], child);
+            }
+            else
+            {
+                Emit(PatchOperation::Kind::Insert).Subtree.emplace(child);
+                current.insert(current.begin() + j, Inserted);
+            }
+            m_path.pop_back();
+        }
+
+        for (auto i = current.size(); i > next.size(); --i)
+        {
+            m_path.push_back(static_cast<std::uint32_t>(i - 1));
+            Emit(PatchOperation::Kind::Remove);
+            m_path.pop_back();
+        }
+    }
+};
+
+/**
+ * Reads a serialized patch, see Patch::Serialize().
+ */
+class PatchReader
+{
+public:
+    explicit PatchReader(std::string_view text) : m_text(text) {}
+
+    [[nodiscard]] bool AtEnd() const { return m_position == m_text.size(); }
+
+    PatchOperation ReadOperation()
+    {
+        PatchOperation op;
+        const char     kind = Peek();
+        if (std::string_view {"+-*>~=!"}.find(kind) == std::string_view::npos)
+        {
+            Fail("Unknown patch operation");
+        }
+        op.Type = static_cast<PatchOperation::Kind>(Read());
+
+        if (Peek() != ' ')
+        {
+            op.Path.push_back(ReadNumber());
+            while (Peek() == '.')
+            {
+                ++m_position;
+                op.Path.push_back(ReadNumber());
+            }
+        }
+        Expect(' ');
+
+        switch (op.Type)
+        {
+            case PatchOperation::Kind::Insert:
+            case PatchOperation::Kind::Replace: op.Subtree.emplace(ReadNode()); break;
+            case PatchOperation::Kind::Remove: break;
+            case PatchOperation::Kind::Move:
+                op.From = ReadNumber();
+                Expect(' ');
+                break;
+            case PatchOperation::Kind::ReplaceText: op.Value = ReadString(); break;
+            case PatchOperation::Kind::SetAttribute:
+                op.Key   = ReadString();
+                op.Value = ReadString();
+                break;
+            case PatchOperation::Kind::RemoveAttribute: op.Key = ReadString(); break;
+        }
+        Expect('\n');
+        return op;
+    }
+
+private:
+    std::string_view m_text;
+    std::size_t      m_position = 0;
+
+    SymbolCache<TagNameTraits>      m_tagNames;
+    SymbolCache<AttributeKeyTraits> m_attributeKeys;
+
+    [[noreturn]] void Fail(std::string_view what) const
+    {
+        throw std::invalid_argument(std::string {what} + " at offset " +
+                                    std::to_string(m_position) + " of the patch");
+    }
+
+    [[nodiscard]] char Peek() const { return AtEnd() ? '\0' : m_text[m_position]; }
+
+    char Read()
+    {
+        if (AtEnd())
+        {
+            Fail("Unexpected end");
+        }
+        return m_text[m_position++];
+    }
+
+    void Expect(char c)
+    {
+        if (Peek() != c)
+        {
+            Fail(std::string {"Expected '"} + c + "'");
+        }
+        ++m_position;
+    }
+
+    std::uint32_t ReadNumber()
+    {
+        std::uint32_t value = 0;
+        const auto [end, error] =
+          std::from_chars(m_text.data() + m_position, m_text.data() + m_text.size(), value);
+        if (error != std::errc {})
+        {
+            Fail("Expected a number");
+        }
+        m_position = static_cast<std::size_t>(end - m_text.data());
+        return value;
+    }
+
+    std::string_view ReadString()
+    {
+        const std::size_t size = ReadNumber();
+        Expect(':');
+        if (size > m_text.size() - m_position)
+        {
+            Fail("String runs past the end");
+        }
+        const std::string_view str = m_text.substr(m_position, size);
+        m_position += size;
+        return str;
+    }
+
+    Tag ReadNode()
+    {
+        const std::string_view name = ReadString();
+        if (name.empty())
+        {
+            Fail("Expected a tag name");
+        }
+        Tag tag {m_tagNames(name), ReadString()};
+        tag.RawText = ReadNumber() != 0;
+        Expect(' ');
+
+        const std::uint32_t attributes = ReadNumber();
+        Expect(' ');
+        for (std::uint32_t i = 0; i < attributes; ++i)
+        {
+            const AttributeKey key = m_attributeKeys(ReadString());
+            tag.Attributes.emplace_back(key, ReadString());
+        }
+
+        const std::uint32_t children = ReadNumber();
+        Expect(' ');
+        for (std::uint32_t i = 0; i < children; ++i)
+        {
+            tag.Children.push_back(ReadNode());
+        }
+        return tag;
+    }
+};
+}    // namespace Detail
+
+/**
+ * The operations that turn a tag tree into another.
+ *
+ * Only the parts that changed are in a patch, so sending one instead of the whole page makes the
+ * bandwidth, and the work of the client, proportional to the size of the change:
+ * @code
+ * Patch patch = Patch::Diff(before, after, {.MatchById = true});
+ * Send(patch.Serialize());
+ * // On the other end:
+ * Patch::Parse(received).ApplyTo(page);
+ * @endcode
+ */
+struct Patch
+{
+    std::vector<PatchOperation> Operations;
+
+    [[nodiscard]] bool Empty() const { return Operations.empty(); }
+
+    /**
+     * Computes the operations that turn @c before into @c after.
+     *
+     * Each node is visited once, pairing up children takes linear time unless many of them are
+     * moved around.
+     *
+     * @throws std::invalid_argument if a tag that is in both trees has generated children.
+     */
+    [[nodiscard]] static Patch Diff(const Tag&         before,
+                                    const Tag&         after,
+                                    const DiffOptions& options = {})
+    {
+        Patch               patch;
+        Detail::TreeDiffer differ {options, patch.Operations};
+        differ.DiffMatched(before, after);
+        return patch;
+    }
+
+    /**
+     * Applies the operations, in order, to @c root.
+     *
+     * @throws std::out_of_range if an operation refers to a node that doesn't exist.
+     */
+    void ApplyTo(Tag& root) const
+    {
+        for (const auto& op : Operations)
+        {
+            Apply(root, op);
+        }
+    }
+
+    /**
+     * Writes the patch in a compact text format, one operation per line:
+     *  - the character of its kind, followed by its path (indices separated with '.') and a space;
+     *  - its arguments: strings are prefixed with their size and a colon, numbers are followed by
+     *    a space, and a tag is written as its name, its text, its raw text flag, its attributes
+     *    (count, then key and value) and its children (count, then each child).
+     *
+     * For instance, "+1.0 1:p5:Hello0 0 0 \n" inserts <p>Hello</p> as the first child of the
+     * second child of the root. Strings are written as-is, there is nothing to escape.
+     */
+    [[nodiscard]] std::string Serialize() const
+    {
+        std::string out;
+        for (const auto& op : Operations)
+        {
+            out += static_cast<char>(op.Type);
+            for (std::size_t i = 0; i < op.Path.size(); ++i)
+            {
+                if (i != 0)
+                {
+                    out += '.';
+                }
+                out += std::to_string(op.Path[i]);
+            }
+            out += ' ';
+
+            switch (op.Type)
+            {
+                case PatchOperation::Kind::Insert:
+                case PatchOperation::Kind::Replace: WriteNode(out, *op.Subtree); break;
+                case PatchOperation::Kind::Remove: break;
+                case PatchOperation::Kind::Move: WriteNumber(out, op.From); break;
+                case PatchOperation::Kind::ReplaceText: WriteString(out, op.Value); break;
+                case PatchOperation::Kind::SetAttribute:
+                    WriteString(out, op.Key);
+                    WriteString(out, op.Value);
+                    break;
+                case PatchOperation::Kind::RemoveAttribute: WriteString(out, op.Key); break;
+            }
+            out += '\n';
+        }
+        return out;
+    }
+
+    /**
+     * Reads a patch written by Serialize().
+     *
+     * @throws std::invalid_argument if @c text is not a valid patch.
+     */
+    [[nodiscard]] static Patch Parse(std::string_view text)
+    {
+        Patch               patch;
+        Detail::PatchReader reader {text};
+        while (!reader.AtEnd())
+        {
+            patch.Operations.push_back(reader.ReadOperation());
+        }
+        return patch;
+    }
+
+private:
+    static Tag& NodeAt(Tag& root, std::span<const std::uint32_t> path)
+    {
+        Tag* node = &root;
+        for (const std::uint32_t index : path)
+        {
+            if (index >= node->Children.size())
+            {
+                throw std::out_of_range("No such node in the tag tree");
+            }
+            node = &node->Children[index];
+        }
+        return *node;
+    }
+
+    static void Apply(Tag& root, const PatchOperation& op)
+    {
+        using Kind = PatchOperation::Kind;
+
+        const std::span<const std::uint32_t> path {op.Path};
+        if (op.Type == Kind::Replace || op.Type == Kind::ReplaceText ||
+            op.Type == Kind::SetAttribute || op.Type == Kind::RemoveAttribute)
+        {
+            Tag& node = NodeAt(root, path);
+            switch (op.Type)
+            {
+                case Kind::Replace: node = *op.Subtree; break;
+                case Kind::ReplaceText: node.Text = op.Value; break;
+                case Kind::SetAttribute:
+                {
+                    const AttributeKey key {op.Key};
+                    const auto it = std::ranges::find(node.Attributes, key, &Tag::Attribute::first);
+                    if (it != node.Attributes.end())
+                    {
+                        it->second = op.Value;
+                    }
+                    else
+                    {
+                        node.Attributes.emplace_back(key, op.Value);
+                    }
+                    break;
+                }
+                default:
+                {
+                    const AttributeKey key {op.Key};
+                    std::erase_if(node.Attributes,
+                                  [key](const Tag::Attribute& attribute)
+                                  { return attribute.first == key; });
+                    break;
+                }
+            }
+            return;
+        }
+
+        if (path.empty())
+        {
+            throw std::out_of_range("The root of a tag tree has no parent");
+        }
+        auto&               children = NodeAt(root, path.first(path.size() - 1)).Children;
+        const std::uint32_t index    = path.back();
+        switch (op.Type)
+        {
+            case Kind::Insert:
+                if (index > children.size())
+                {
+                    throw std::out_of_range("Cannot insert past the end of the children");
+                }
+                children.insert(children.begin() + index, *op.Subtree);
+                break;
+            case Kind::Remove:
+                if (index >= children.size())
+                {
+                    throw std::out_of_range("No such node in the tag tree");
+                }
+                children.erase(children.begin() + index);
+                break;
+            default:
+            {
+                if (op.From >= children.size() || index >= children.size())
+                {
+                    throw std::out_of_range("No such node in the tag tree");
+                }
+                Tag moved = std::move(children[op.From]);
+                children.erase(children.begin() + op.From);
+                children.insert(children.begin() + index, std::move(moved));
+                break;
+            }
+        }
+    }
+
+    static void WriteNumber(std::string& out, std::size_t value)
+    {
+        out += std::to_string(value);
+        out += ' ';
+    }
+
+    static void WriteString(std::string& out, std::string_view str)
+    {
+        out += std::to_string(str.size());
+        out += ':';
+        out += str;
+    }
+
+    static void WriteNode(std::string& out, const Tag& tag)
+    {
+        WriteString(out, tag.Name.View());
+        WriteString(out, tag.Text);
+        WriteNumber(out, tag.RawText ? 1 : 0);
+        WriteNumber(out, tag.Attributes.size());
+        for (const auto& [key, value] : tag.Attributes)
+        {
+            WriteString(out, key.View());
+            WriteString(out, value);
+        }
+
+        std::size_t children = 0;
+        tag.ForEachChild([&children](const Tag&) { ++children; });
+        WriteNumber(out, children);
+        tag.ForEachChild([&out](const Tag& child) { WriteNode(out, child); });
+    }
+};
+
+#endif    // DESIGN_PATTERNS_TREE_DIFF_H
@@ -0,0 +1,597 @@
+/**
+ * @file    typed_document.h
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief   Documents whose structure is part of their type.
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+
+
+#ifndef DESIGN_PATTERNS_TYPED_DOCUMENT_H
+#define DESIGN_PATTERNS_TYPED_DOCUMENT_H
+
+#include <algorithm>
+#include <array>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <ostream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#include "escape.h"
+#include "names.h"
+#include "render.h"
+#include "tag.h"
+#include "tags.h"
+
+/**
+ * Documents whose structure is known at compile time, but whose strings are only known at runtime.
+ *
+ * They are written with the same syntax as Tag trees:
+ * @code
+ * std::cout << Typed::Html {
+ *     Typed::Head {Typed::Title {"My Page"}},
+ *     Typed::Body {Typed::H1 {title}, Typed::Img {url}}
+ * };
+ * @endcode
+ *
+ * Instead of being sliced into a Tag, every element keeps its own type, which holds the types of
+ * its children in a std::tuple. A document is thus a single object, without any vector or any
+ * allocation other than for the temporary strings it was given, and rendering it is unrolled by
+ * the compiler into a sequence of writes whose markup, tag names included, is made of constants.
+ *
+ * Temporary std::strings are moved into the document, any other string is only referred to and
+ * must outlive it.
+ *
+ * The output is the same as the one of the equivalent Tag tree, which ToTag() builds.
+ */
+namespace Typed
+{
+namespace Detail
+{
+template<std::size_t Size>
+constexpr std::array<char, Size> Join(std::initializer_list<std::string_view> parts)
+{
+    std::array<char, Size> out {};
+    std::size_t            i = 0;
+    for (std::string_view part : parts)
+    {
+        for (char c : part)
+        {
+            out[i++] = c;
+        }
+    }
+    return out;
+}
+
+template<std::size_t Size>
+constexpr std::string_view View(const std::array<char, Size>& chars, std::size_t size = Size)
+{
+    return {chars.data(), size};
+}
+
+//! The markup of a tag, joined at compile time.
+template<TagId Id>
+struct TagLiterals
+{
+    static constexpr std::string_view Name    = TagName {Id}.View();
+    static constexpr auto             Opening = Join<Name.size() + 1>({"<", Name});
+    //! The minified format leaves out the line break.
+    static constexpr auto Closing = Join<Name.size() + 4>({"</", Name, ">\n"});
+};
+
+template<AttributeId Key>
+struct AttributeLiterals
+{
+    static constexpr std::string_view Name   = AttributeKey {Key}.View();
+    static constexpr auto             Prefix = Join<Name.size() + 3>({" ", Name, "=\""});
+};
+
+template<typename T>
+concept TextArgument = std::convertible_to<T, std::string_view>;
+
+//! Temporary strings are moved into the document, anything else is only referred to.
+template<typename T>
+using StoredString =
+  std::conditional_t<std::is_same_v<T, std::string>, std::string, std::string_view>;
+
+/**
+ * The text of an element.
+ */
+template<typename String, bool Raw = false>
+struct Text
+{
+    static constexpr bool IsRaw = Raw;
+
+    String Value;
+
+    template<typename T>
+        requires std::constructible_from<String, T&&>
+    Text(T&& value) : Value(std::forward<T>(value))
+    {
+    }
+
+    [[nodiscard]] std::string_view View() const { return Value; }
+};
+
+/**
+ * An attribute of an element.
+ *
+ * @tparam OmitEmpty Leaves the attribute out when its value is empty.
+ */
+template<AttributeId Key, typename String, bool OmitEmpty = false>
+struct Attribute
+{
+    static constexpr AttributeId KeyId          = Key;
+    static constexpr bool        OmittedIfEmpty = OmitEmpty;
+
+    String Value;
+
+    template<typename T>
+        requires std::constructible_from<String, T&&>
+    Attribute(T&& value) : Value(std::forward<T>(value))
+    {
+    }
+
+    [[nodiscard]] std::string_view View() const { return Value; }
+    [[nodiscard]] bool             IsWritten() const { return !OmitEmpty || !Value.empty(); }
+};
+
+template<typename T>
+struct IsText : std::false_type
+{
+};
+
+template<typename String, bool Raw>
+struct IsText<Text<String, Raw>> : std::true_type
+{
+};
+
+template<typename T>
+struct IsAttribute : std::false_type
+{
+};
+
+template<AttributeId Key, typename String, bool OmitEmpty>
+struct IsAttribute<Attribute<Key, String, OmitEmpty>> : std::true_type
+{
+};
+
+//! Base of every element, to tell them apart from their text and attributes.
+struct ElementBase
+{
+};
+
+template<typename T>
+concept ElementPart = std::derived_from<T, ElementBase>;
+
+template<typename T>
+concept Part = ElementPart<T> || IsText<T>::value || IsAttribute<T>::value;
+
+template<typename T>
+using TextFor = Text<StoredString<T>>;
+
+/**
+ * An element, made of parts: its attributes, its text and its children, in that order.
+ *
+ * Each tag of the DSL derives from it, only adding how its arguments turn into parts.
+ */
+template<TagId NameId, Part... Parts>
+class Element : public ElementBase
+{
+public:
+    using Literals = TagLiterals<NameId>;
+
+    static constexpr TagName Name {NameId};
+
+    Element(Parts... parts) : m_parts(std::move(parts)...) {}
+
+    [[nodiscard]] bool IsEmpty() const
+    {
+        if constexpr ((ElementPart<Parts> || ...))
+        {
+            return false;
+        }
+        else
+        {
+            return std::apply([](const auto&... part) { return (IsEmptyPart(part) && ...); },
+                              m_parts);
+        }
+    }
+
+    [[nodiscard]] std::size_t RenderedSize(std::size_t indent = 0) const
+    {
+        return RenderedSize(RenderOptions {.Indent = indent});
+    }
+
+    [[nodiscard]] std::size_t RenderedSize(const RenderOptions& options) const
+    {
+        SizeCounter counter;
+        Write(counter, options);
+        return counter.Size;
+    }
+
+    void RenderTo(std::string& out, std::size_t indent = 0) const
+    {
+        RenderTo(out, RenderOptions {.Indent = indent});
+    }
+
+    void RenderTo(std::string& out, const RenderOptions& options) const
+    {
+        const std::size_t offset = out.size();
+        out.resize(offset + RenderedSize(options));
+
+        BufferWriter writer {out.data() + offset};
+        Write(writer, options);
+    }
+
+    [[nodiscard]] std::string Render(std::size_t indent = 0) const
+    {
+        return Render(RenderOptions {.Indent = indent});
+    }
+
+    [[nodiscard]] std::string Render(const RenderOptions& options) const
+    {
+        std::string out;
+        RenderTo(out, options);
+        return out;
+    }
+
+    /**
+     * @throws std::invalid_argument if OmitOptionalClosingTags is set, typed documents always
+     * write their closing tags.
+     */
+    template<typename Writer>
+    void Write(Writer& writer, const RenderOptions& options) const
+    {
+        if (options.Style == RenderOptions::Format::Pretty)
+        {
+            Write(writer, options.Indent);
+        }
+        else if (options.OmitOptionalClosingTags)
+        {
+            throw std::invalid_argument("Typed documents always write their closing tags");
+        }
+        else
+        {
+            WriteMinified(writer);
+        }
+    }
+
+    /**
+     * Writes the element in the same format as Tag::Write().
+     *
+     * @tparam Writer See render.h
+     */
+    template<typename Writer>
+    void Write(Writer& writer, std::size_t indent) const
+    {
+        using namespace std::string_view_literals;
+
+        writer.Indent(indent);
+        writer.Append(View(Literals::Opening));
+        WriteAttributes(writer);
+
+        if (IsEmpty())
+        {
+            writer.Append("/>\n"sv);
+            return;
+        }
+
+        writer.Append(">\n"sv);
+        std::apply([&writer, indent](const auto&... part)
+                   { (WritePart(writer, part, indent + Tag::IndentSize), ...); },
+                   m_parts);
+
+        writer.Indent(indent);
+        writer.Append(View(Literals::Closing));
+    }
+
+    /**
+     * Writes the element in the same format as Tag::WriteMinified().
+     */
+    template<typename Writer>
+    void WriteMinified(Writer& writer) const
+    {
+        using namespace std::string_view_literals;
+
+        writer.Append(View(Literals::Opening));
+        WriteAttributes(writer);
+        writer.Append(">"sv);
+
+        if (IsVoidElement(NameId, Literals::Name) && IsEmpty())
+        {
+            return;
+        }
+
+        std::apply([&writer](const auto&... part) { (WriteMinifiedPart(writer, part), ...); },
+                   m_parts);
+        writer.Append(View(Literals::Closing, Literals::Closing.size() - 1));
+    }
+
+    /**
+     * Builds the equivalent Tag tree.
+     */
+    [[nodiscard]] Tag ToTag() const
+    {
+        Tag tag {Name, std::string_view {}};
+        tag.Children.reserve((static_cast<std::size_t>(ElementPart<Parts>) + ... + 0));
+        std::apply([&tag](const auto&... part) { (AddTo(tag, part), ...); }, m_parts);
+        return tag;
+    }
+
+    friend std::ostream& operator<<(std::ostream& os, const Element& element)
+    {
+        // The width of the stream is used as the indentation of the element.
+        const auto        width    = std::max<std::streamsize>(os.width(0), 0);
+        const std::string rendered = element.Render(static_cast<std::size_t>(width));
+        return os.write(rendered.data(), static_cast<std::streamsize>(rendered.size()));
+    }
+
+private:
+    std::tuple<Parts...> m_parts;
+
+    template<typename P>
+    static bool IsEmptyPart(const P& part)
+    {
+        if constexpr (IsText<P>::value)
+        {
+            return part.View().empty();
+        }
+        else
+        {
+            return true;
+        }
+    }
+
+    template<typename Writer>
+    void WriteAttributes(Writer& writer) const
+    {
+        std::apply([&writer](const auto&... part) { (WriteAttribute(writer, part), ...); },
+                   m_parts);
+    }
+
+    template<typename Writer, typename P>
+    static void WriteAttribute(Writer& writer, const P& part)
+    {
+        using namespace std::string_view_literals;
+
+        if constexpr (IsAttribute<P>::value)
+        {
+            if (part.IsWritten())
+            {
+                writer.Append(View(AttributeLiterals<P::KeyId>::Prefix));
+                WriteEscaped(writer, part.View());
+                writer.Append("\""sv);
+            }
+        }
+    }
+
+    template<typename Writer, typename P>
+    static void WriteText(Writer& writer, const P& part)
+    {
+        if constexpr (P::IsRaw)
+        {
+            writer.Append(part.View());
+        }
+        else
+        {
+            WriteEscaped(writer, part.View());
+        }
+    }
+
+    template<typename Writer, typename P>
+    static void WritePart(Writer& writer, const P& part, std::size_t indent)
+    {
+        using namespace std::string_view_literals;
+
+        if constexpr (IsText<P>::value)
+        {
+            if (!part.View().empty())
+            {
+                writer.Indent(indent);
+                WriteText(writer, part);
+                writer.Append("\n"sv);
+            }
+        }
+        else if constexpr (ElementPart<P>)
+        {
+            part.Write(writer, indent);
+        }
+    }
+
+    template<typename Writer, typename P>
+    static void WriteMinifiedPart(Writer& writer, const P& part)
+    {
+        if constexpr (IsText<P>::value)
+        {
+            WriteText(writer, part);
+        }
+        else if constexpr (ElementPart<P>)
+        {
+            part.WriteMinified(writer);
+        }
+    }
+
+    template<typename P>
+    static void AddTo(Tag& tag, const P& part)
+    {
+        if constexpr (IsText<P>::value)
+        {
+            tag.Text.append(part.View());
+            tag.RawText = P::IsRaw;
+        }
+        else if constexpr (IsAttribute<P>::value)
+        {
+            if (part.IsWritten())
+            {
+                tag.Attributes.emplace_back(P::KeyId, part.View());
+            }
+        }
+        else
+        {
+            tag.Children.push_back(part.ToTag());
+        }
+    }
+};
+
+using LangAttribute = Attribute<AttributeId::Lang, std::string_view>;
+
+constexpr std::string_view DirectionToStr(::Bdo::Direction dir)
+{
+    using namespace std::string_view_literals;
+    switch (dir)
+    {
+        case ::Bdo::Direction::Ltr: return "ltr"sv;
+        case ::Bdo::Direction::Rtl: return "rtl"sv;
+        default: return ""sv;
+    }
+}
+}    // namespace Detail
+
+template<typename... Parts>
+struct Html : Detail::Element<TagId::Html, Detail::LangAttribute, Parts...>
+{
+    // The lang tag should always be included.
+    Html(Parts... children)
+    : Detail::Element<TagId::Html, Detail::LangAttribute, Parts...>("en", std::move(children)...)
+    {
+    }
+};
+
+// Elements made of children only.
+// clang-format off
+template<typename... Parts> struct Head : Detail::Element<TagId::Head, Parts...> { using Detail::Element<TagId::Head, Parts...>::Element; };
+template<typename... Parts> struct Body : Detail::Element<TagId::Body, Parts...> { using Detail::Element<TagId::Body, Parts...>::Element; };
+template<typename... Parts> struct Address : Detail::Element<TagId::Address, Parts...> { using Detail::Element<TagId::Address, Parts...>::Element; };
+template<typename... Parts> struct Ul : Detail::Element<TagId::Ul, Parts...> { using Detail::Element<TagId::Ul, Parts...>::Element; };
+template<typename... Parts> struct Ol : Detail::Element<TagId::Ol, Parts...> { using Detail::Element<TagId::Ol, Parts...>::Element; };
+
+template<Detail::ElementPart... Parts> Head(Parts...) -> Head<Parts...>;
+template<Detail::ElementPart... Parts> Body(Parts...) -> Body<Parts...>;
+template<Detail::ElementPart... Parts> Address(Parts...) -> Address<Parts...>;
+template<Detail::ElementPart... Parts> Ul(Parts...) -> Ul<Parts...>;
+template<Detail::ElementPart... Parts> Ol(Parts...) -> Ol<Parts...>;
+// clang-format on
+
+// Elements made of either text or children.
+// clang-format off
+template<typename... Parts> struct P : Detail::Element<TagId::P, Parts...> { using Detail::Element<TagId::P, Parts...>::Element; };
+template<typename... Parts> struct Li : Detail::Element<TagId::Li, Parts...> { using Detail::Element<TagId::Li, Parts...>::Element; };
+
+template<Detail::TextArgument T> P(T&&) -> P<Detail::TextFor<T>>;
+template<Detail::TextArgument T> Li(T&&) -> Li<Detail::TextFor<T>>;
+template<Detail::ElementPart... Parts> P(Parts...) -> P<Parts...>;
+template<Detail::ElementPart... Parts> Li(Parts...) -> Li<Parts...>;
+// clang-format on
+
+// Elements made of text only.
+// clang-format off
+template<typename... Parts> struct Title : Detail::Element<TagId::Title, Parts...> { using Detail::Element<TagId::Title, Parts...>::Element; };
+template<typename... Parts> struct H1 : Detail::Element<TagId::H1, Parts...> { using Detail::Element<TagId::H1, Parts...>::Element; };
+template<typename... Parts> struct H2 : Detail::Element<TagId::H2, Parts...> { using Detail::Element<TagId::H2, Parts...>::Element; };
+template<typename... Parts> struct H3 : Detail::Element<TagId::H3, Parts...> { using Detail::Element<TagId::H3, Parts...>::Element; };
+template<typename... Parts> struct H4 : Detail::Element<TagId::H4, Parts...> { using Detail::Element<TagId::H4, Parts...>::Element; };
+template<typename... Parts> struct H5 : Detail::Element<TagId::H5, Parts...> { using Detail::Element<TagId::H5, Parts...>::Element; };
+template<typename... Parts> struct H6 : Detail::Element<TagId::H6, Parts...> { using Detail::Element<TagId::H6, Parts...>::Element; };
+template<typename... Parts> struct B : Detail::Element<TagId::B, Parts...> { using Detail::Element<TagId::B, Parts...>::Element; };
+template<typename... Parts> struct Bdi : Detail::Element<TagId::Bdi, Parts...> { using Detail::Element<TagId::Bdi, Parts...>::Element; };
+template<typename... Parts> struct Cite : Detail::Element<TagId::Cite, Parts...> { using Detail::Element<TagId::Cite, Parts...>::Element; };
+template<typename... Parts> struct Del : Detail::Element<TagId::Del, Parts...> { using Detail::Element<TagId::Del, Parts...>::Element; };
+template<typename... Parts> struct Code : Detail::Element<TagId::Code, Parts...> { using Detail::Element<TagId::Code, Parts...>::Element; };
+
+template<Detail::TextArgument T> Title(T&&) -> Title<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H1(T&&) -> H1<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H2(T&&) -> H2<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H3(T&&) -> H3<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H4(T&&) -> H4<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H5(T&&) -> H5<Detail::TextFor<T>>;
+template<Detail::TextArgument T> H6(T&&) -> H6<Detail::TextFor<T>>;
+template<Detail::TextArgument T> B(T&&) -> B<Detail::TextFor<T>>;
+template<Detail::TextArgument T> Bdi(T&&) -> Bdi<Detail::TextFor<T>>;
+template<Detail::TextArgument T> Cite(T&&) -> Cite<Detail::TextFor<T>>;
+template<Detail::TextArgument T> Del(T&&) -> Del<Detail::TextFor<T>>;
+// Code is written as-is, it is up to the caller to make sure that it is valid HTML.
+template<Detail::TextArgument T> Code(T&&) -> Code<Detail::Text<Detail::StoredString<T>, true>>;
+// clang-format on
+
+struct Br : Detail::Element<TagId::Br>
+{
+};
+
+struct Hr : Detail::Element<TagId::Hr>
+{
+};
+
+template<typename... Parts>
+struct Img : Detail::Element<TagId::Img, Parts...>
+{
+    using Detail::Element<TagId::Img, Parts...>::Element;
+};
+
+// The URL of an image is in the attribute list of the tag.
+template<Detail::TextArgument T>
+Img(T&&) -> Img<Detail::Attribute<AttributeId::Src, Detail::StoredString<T>>>;
+
+template<typename... Parts>
+struct Abbr : Detail::Element<TagId::Abbr, Parts...>
+{
+    using Detail::Element<TagId::Abbr, Parts...>::Element;
+};
+
+template<Detail::TextArgument T, Detail::TextArgument U>
+Abbr(T&&, U&&)
+  -> Abbr<Detail::TextFor<T>, Detail::Attribute<AttributeId::Title, Detail::StoredString<U>>>;
+
+template<typename... Parts>
+struct Blockquote : Detail::Element<TagId::Blockquote, Parts...>
+{
+    using Detail::Element<TagId::Blockquote, Parts...>::Element;
+};
+
+template<Detail::TextArgument T>
+Blockquote(T&&) -> Blockquote<Detail::TextFor<T>>;
+template<Detail::TextArgument T, Detail::TextArgument U>
+Blockquote(T&&, U&&)
+  -> Blockquote<Detail::TextFor<T>,
+                Detail::Attribute<AttributeId::Cite, Detail::StoredString<U>, true>>;
+
+template<typename... Parts>
+struct Bdo : Detail::Element<TagId::Bdo, Parts...>
+{
+    using Direction = ::Bdo::Direction;
+
+    template<typename T>
+    Bdo(Direction dir, T&& text)
+    : Detail::Element<TagId::Bdo, Parts...>(Detail::DirectionToStr(dir), std::forward<T>(text))
+    {
+    }
+};
+
+template<Detail::TextArgument T>
+Bdo(::Bdo::Direction, T&&)
+  -> Bdo<Detail::Attribute<AttributeId::Dir, std::string_view>, Detail::TextFor<T>>;
+}    // namespace Typed
+
+#endif    // DESIGN_PATTERNS_TYPED_DOCUMENT_H
@@ -0,0 +1,969 @@
+/**
+ * @file    groovy_builder_benchmark.cpp
+ * @author  Samuel Martel
+ * @p       https://github.com/smartel99
+ * @date    2026-10-16
+ *
+ * @brief
+ ******************************************************************************
+ * Copyright (C) 2022  Samuel Martel
+ *
+ *   This program is free software: you can redistribute it and/or modify
+ *   it under the terms of the GNU General Public License as published by
+ *   the Free Software Foundation, either version 3 of the License, or
+ *   (at your option) any later version.
+ *
+ *   This program is distributed in the hope that it will be useful,
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *   GNU General Public License for more details.
+ *
+ *   You should have received a copy of the GNU General Public License
+ *   along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *****************************************************************************/
+/**
+ * This program measures the cost of building and rendering documents with the groovy builder.
+ *
+ * It is built with GROOVY_BUILDER_COUNT_COPIES defined, so that deep copies of tags are counted.
+ */
+
+#include <chrono>
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <cstddef>
+#include <cstdlib>
+#include <iostream>
+#include <ranges>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "groovy_builder/binary_document.h"
+#include "groovy_builder/compiled_template.h"
+#include "groovy_builder/escape.h"
+#include "groovy_builder/flat_document.h"
+#include "groovy_builder/html_parser.h"
+#include "groovy_builder/img.h"
+#include "groovy_builder/live_document.h"
+#include "groovy_builder/mapped_file.h"
+#include "groovy_builder/parallel_renderer.h"
+#include "groovy_builder/pull_renderer.h"
+#include "groovy_builder/selector.h"
+#include "groovy_builder/shared_tree.h"
+#include "groovy_builder/static_document.h"
+#include "groovy_builder/stream_renderer.h"
+#include "groovy_builder/tag_arena.h"
+#include "groovy_builder/tags.h"
+#include "groovy_builder/tree_diff.h"
+#include "groovy_builder/typed_document.h"
+
+namespace
+{
+template<typename Func>
+double MeasureMs(Func&& func, int iterations)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i)
+    {
+        func();
+    }
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+    return std::chrono::duration<double, std::milli>(elapsed).count() / iterations;
+}
+
+// The children are passed through a std::initializer_list, which can only be copied from.
+Tag BuildWithInitializerLists(int depth)
+{
+    if (depth == 0)
+    {
+        return P {"Some leaf text that is long enough to not fit in the small string buffer"};
+    }
+    return Tag("div", {BuildWithInitializerLists(depth - 1), BuildWithInitializerLists(depth - 1)});
+}
+
+// The children are forwarded to the variadic constructor, which moves them in place.
+Tag BuildWithMoves(int depth)
+{
+    if (depth == 0)
+    {
+        return P {"Some leaf text that is long enough to not fit in the small string buffer"};
+    }
+    return Tag("div", BuildWithMoves(depth - 1), BuildWithMoves(depth - 1));
+}
+
+Tag BuildPage()
+{
+    // clang-format off
+    return Html {
+        Head {
+            Title {"My Page"}
+        },
+        Body {
+            H1 {"My Title"},
+            H2 {"My Subtitle"},
+            P {"Some text"},
+            Img {"link/to/an/image.jpg"},
+            Blockquote {
+                "This is my image",
+                "This is my source"
+            }
+        }
+    };
+    // clang-format on
+}
+
+// A page made of many small sections, closer to what is rendered in production.
+Tag BuildLargePage(int sections)
+{
+    std::pmr::vector<Tag> children {Tag::allocator_type {CurrentTagResource()}};
+    children.reserve(static_cast<std::size_t>(sections));
+    for (int i = 0; i < sections; ++i)
+    {
+        // clang-format off
+        children.emplace_back(Tag {
+            "section",
+            H2 {"Section " + std::to_string(i)},
+            P {
+                B {"Some bold text"},
+                Abbr {"HTML", "HyperText Markup Language"}
+            },
+            Img {"link/to/image_" + std::to_string(i) + ".jpg"},
+            Blockquote {"This is a quote", "https://example.com"}
+        });
+        // clang-format on
+    }
+    return Html {Head {Title {"My Large Page"}}, Tag {"body", std::move(children)}};
+}
+
+void BenchmarkConstruction()
+{
+    static constexpr int Depth      = 12;
+    static constexpr int Iterations = 20;
+
+    std::cout << "Construction of a binary tree of depth " << Depth << ":\n";
+
+    Tag::CopyCount           = 0;
+    const double initListMs  = MeasureMs([] { BuildWithInitializerLists(Depth); }, Iterations);
+    const auto   initListCnt = Tag::CopyCount / Iterations;
+
+    Tag::CopyCount        = 0;
+    const double movedMs  = MeasureMs([] { BuildWithMoves(Depth); }, Iterations);
+    const auto   movedCnt = Tag::CopyCount / Iterations;
+
+    Tag::CopyCount       = 0;
+    const double pageMs  = MeasureMs([] { BuildPage(); }, Iterations);
+    const auto   pageCnt = Tag::CopyCount / Iterations;
+
+    std::cout << "  initializer_list: " << initListMs << " ms, " << initListCnt << " copies\n"
+              << "  variadic moves:   " << movedMs << " ms, " << movedCnt << " copies\n"
+              << "  example page:     " << pageMs << " ms, " << pageCnt << " copies\n";
+}
+
+void BenchmarkArena()
+{
+    static constexpr int Depth      = 12;
+    static constexpr int Iterations = 20;
+
+    std::cout << "Heap usage of a binary tree of depth " << Depth << ", built once per request:\n";
+
+    CountingResource heap;
+
+    const double heapMs = MeasureMs(
+      [&heap]
+      {
+          ScopedTagResource scope {&heap};
+          BuildWithMoves(Depth);
+      },
+      Iterations);
+    const auto heapAllocations = heap.Allocations() / Iterations;
+    const auto heapBytes       = heap.BytesAllocated() / Iterations;
+
+    heap.ResetCounters();
+    TagArena     arena {TagArena::DefaultInitialSize, &heap};
+    const double arenaMs = MeasureMs(
+      [&arena]
+      {
+          arena.Build([] { return BuildWithMoves(Depth); });
+          arena.Reset();
+      },
+      Iterations);
+    const auto arenaAllocations = heap.Allocations() / Iterations;
+    const auto arenaBytes       = heap.BytesAllocated() / Iterations;
+
+    std::cout << "  global heap: " << heapMs << " ms, " << heapAllocations << " allocations, "
+              << heapBytes << " bytes\n"
+              << "  arena:       " << arenaMs << " ms, " << arenaAllocations << " allocations, "
+              << arenaBytes << " bytes\n";
+}
+
+void BenchmarkFlatDocument()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 10;
+
+    CountingResource heap;
+    Tag              page = [&heap]
+    {
+        ScopedTagResource scope {&heap};
+        return BuildLargePage(Sections);
+    }();
+    const FlatDocument flat = FlatDocument::FromTag(page);
+
+    std::cout << "Rendering a page of " << flat.NodeCount() << " nodes:\n";
+
+    std::size_t  tagSize  = 0;
+    const double tagMs    = MeasureMs([&] { tagSize = page.Render().size(); }, Iterations);
+    std::size_t  flatSize = 0;
+    const double flatMs   = MeasureMs([&] { flatSize = flat.Render().size(); }, Iterations);
+    const double flattenMs = MeasureMs([&] { FlatDocument::FromTag(page); }, Iterations);
+
+    std::cout << "  tag tree:      " << tagMs << " ms, " << tagSize << " bytes of output, "
+              << heap.BytesAllocated() + sizeof(Tag) << " bytes of memory\n"
+              << "  flat document: " << flatMs << " ms, " << flatSize << " bytes of output, "
+              << flat.MemoryUsage() << " bytes of memory\n"
+              << "  conversion:    " << flattenMs << " ms\n";
+}
+
+void BenchmarkStaticDocument()
+{
+    static constexpr int Iterations = 10000;
+
+    // clang-format off
+    static constexpr auto staticPage = Static::Compile([] {
+        return Static::Html(
+            Static::Head(
+                Static::Title("My Page")
+            ),
+            Static::Body(
+                Static::H1("My Title"),
+                Static::H2("My Subtitle"),
+                Static::P("Some text"),
+                Static::Img("link/to/an/image.jpg"),
+                Static::Blockquote("This is my image", "This is my source")
+            )
+        );
+    });
+    static constexpr auto partialPage = Static::Compile([] {
+        return Static::Html(
+            Static::Head(
+                Static::Title("My Page")
+            ),
+            Static::Body(
+                Static::H1(Static::Hole {0}),
+                Static::H2("My Subtitle"),
+                Static::P("Some text"),
+                Static::Img(Static::Hole {1}),
+                Static::Blockquote("This is my image", "This is my source")
+            )
+        );
+    });
+    // clang-format on
+
+    std::cout << "Rendering the example page:\n";
+
+    std::size_t  size      = 0;
+    const double runtimeMs = MeasureMs([&] { size += BuildPage().Render().size(); }, Iterations);
+    const double staticMs  = MeasureMs([&] { size += std::string(staticPage.View()).size(); }, Iterations);
+    const double partialMs = MeasureMs(
+      [&] { size += partialPage.Render({"My Title", "link/to/an/image.jpg"}).size(); }, Iterations);
+
+    std::cout << "  built and rendered at runtime: " << runtimeMs * 1000.0 << " us\n"
+              << "  rendered at compile time:      " << staticMs * 1000.0 << " us\n"
+              << "  with runtime holes:            " << partialMs * 1000.0 << " us\n"
+              << "  identical output: " << std::boolalpha
+              << (staticPage.View() == BuildPage().Render() &&
+                  partialPage.Render({"My Title", "link/to/an/image.jpg"}) == BuildPage().Render())
+              << "\n";
+}
+
+void BenchmarkStreaming()
+{
+    static constexpr int         Sections   = 10000;
+    static constexpr int         Iterations = 10;
+    static constexpr std::size_t ChunkSize  = 16 * 1024;
+
+    const Tag page = BuildLargePage(Sections);
+    const int fd   = ::open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        std::cout << "Unable to open /dev/null, skipping the streaming benchmark\n";
+        return;
+    }
+
+    std::cout << "Writing a page of " << page.RenderedSize() << " bytes to /dev/null:\n";
+
+    const double wholeMs = MeasureMs(
+      [&]
+      {
+          const std::string rendered = page.Render();
+          FdSink {fd}(rendered);
+      },
+      Iterations);
+    std::size_t  chunks   = 0;
+    const double streamMs = MeasureMs(
+      [&]
+      {
+          RenderStream(page,
+                       [&chunks, sink = FdSink {fd}](std::string_view chunk)
+                       {
+                           ++chunks;
+                           sink(chunk);
+                       },
+                       ChunkSize);
+      },
+      Iterations);
+
+    std::cout << "  rendered whole:  " << wholeMs << " ms, " << page.RenderedSize()
+              << " bytes of output buffer\n"
+              << "  streamed:        " << streamMs << " ms, " << ChunkSize
+              << " bytes of output buffer, " << chunks / Iterations << " chunks\n";
+
+    ::close(fd);
+}
+
+// Same as WriteEscaped, but always looking at one character at a time.
+void WriteEscapedScalar(StringWriter& writer, std::string_view str)
+{
+    std::size_t position = 0;
+    while (true)
+    {
+        const std::size_t special = Detail::FindEscapableScalar(str, position);
+        writer.Append(str.substr(position, special - position));
+        if (special == str.size())
+        {
+            return;
+        }
+        writer.Append(EscapeSequence(str[special]));
+        position = special + 1;
+    }
+}
+
+void BenchmarkEscaping()
+{
+    static constexpr std::size_t Size       = 1024 * 1024;
+    static constexpr int         Iterations = 20;
+
+    std::string clean;
+    std::string heavy;
+    while (clean.size() < Size)
+    {
+        clean += "Some perfectly ordinary text, without anything special in it. ";
+        heavy += "if (a < b && c > d) { print(\"it's\"); } ";
+    }
+
+    std::cout << "Escaping 1 MiB of text:\n";
+
+    const auto report = [](const char* label, auto&& escape, const std::string& text)
+    {
+        std::string  out;
+        const double ms = MeasureMs(
+          [&]
+          {
+              out.clear();
+              StringWriter writer {out};
+              escape(writer, text);
+          },
+          Iterations);
+        std::cout << "  " << label << ": " << static_cast<double>(text.size()) / 1000.0 / ms
+                  << " MB/s\n";
+    };
+
+    const auto simd   = [](StringWriter& writer, std::string_view str) { WriteEscaped(writer, str); };
+    const auto scalar = [](StringWriter& writer, std::string_view str) { WriteEscapedScalar(writer, str); };
+    report("clean text, vectorized   ", simd, clean);
+    report("clean text, scalar       ", scalar, clean);
+    report("escape-heavy, vectorized ", simd, heavy);
+    report("escape-heavy, scalar     ", scalar, heavy);
+}
+
+void BenchmarkLiveDocument()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 10;
+
+    const Tag    page = BuildLargePage(Sections);
+    LiveDocument document {page};
+    document.Render();
+    document.ResetStats();
+
+    std::cout << "Re-rendering a page of " << Sections << " sections after changing one title:\n";
+
+    std::size_t  size    = 0;
+    const double fullMs  = MeasureMs([&] { size += page.Render().size(); }, Iterations);
+    int          changes = 0;
+    const double liveMs  = MeasureMs(
+      [&]
+      {
+          // <html> -> <body> -> <section> -> <h2>
+          document.Root().Child(1).Child(Sections / 2).Child(0).SetText(
+            "Changed " + std::to_string(++changes));
+          size += document.Render().size();
+      },
+      Iterations);
+
+    const auto& stats = document.Stats();
+    std::cout << "  full render:        " << fullMs << " ms\n"
+              << "  incremental render: " << liveMs << " ms, " << stats.Hits / Iterations
+              << " hits and " << stats.Misses / Iterations << " misses per render\n";
+}
+
+void BenchmarkParallelRendering()
+{
+    static constexpr int Sections   = 50000;
+    static constexpr int Iterations = 5;
+
+    const Tag page = BuildLargePage(Sections);
+
+    std::cout << "Rendering a page of " << Sections << " sections:\n";
+
+    std::string  serial;
+    const double serialMs = MeasureMs([&] { serial = page.Render(); }, Iterations);
+    std::cout << "  1 thread:  " << serialMs << " ms\n";
+
+    for (unsigned int threads : {2U, 4U, 8U})
+    {
+        ParallelRenderOptions options;
+        options.Threads = threads;
+        const ParallelRenderer renderer {options};
+
+        std::string  parallel;
+        const double parallelMs = MeasureMs([&] { parallel = renderer.Render(page); }, Iterations);
+        std::cout << "  " << threads << " threads: " << parallelMs << " ms, identical output: "
+                  << std::boolalpha << (parallel == serial) << "\n";
+    }
+}
+
+void BenchmarkMinifiedRendering()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 10;
+
+    const Tag           page = BuildLargePage(Sections);
+    const RenderOptions pretty {};
+    const RenderOptions minified {.Style = RenderOptions::Format::Minified};
+    const RenderOptions compact {.Style                   = RenderOptions::Format::Minified,
+                                 .OmitOptionalClosingTags = true};
+
+    std::cout << "Rendering a page of " << Sections << " sections:\n";
+    for (const auto& [label, options] : {std::pair {"pretty:  ", pretty},
+                                         std::pair {"minified:", minified},
+                                         std::pair {"compact: ", compact}})
+    {
+        const double ms = MeasureMs([&] { static_cast<void>(page.Render(options)); }, Iterations);
+        std::cout << "  " << label << " " << ms << " ms, " << page.RenderedSize(options)
+                  << " bytes\n";
+    }
+}
+
+void BenchmarkParsing()
+{
+    static constexpr int Sections   = 20000;
+    static constexpr int Iterations = 5;
+
+    // The corpus is the large page, rendered to a temporary file.
+    char      path[] = "/tmp/groovy_builder_corpusXXXXXX";
+    const int fd     = ::mkstemp(path);
+    if (fd < 0)
+    {
+        std::cout << "Unable to create the corpus, skipping the parsing benchmark\n";
+        return;
+    }
+    RenderStream(BuildLargePage(Sections), FdSink {fd});
+    ::close(fd);
+
+    const MappedFile corpus {path};
+    ::unlink(path);
+
+    const double megabytes = static_cast<double>(corpus.size()) / (1024.0 * 1024.0);
+    const auto   throughput = [megabytes](double ms) { return megabytes / (ms / 1000.0); };
+
+    std::size_t  nodes   = 0;
+    const double parseMs = MeasureMs(
+      [&] { nodes = ParsedDocument::Parse(corpus.View()).NodeCount(); }, Iterations);
+
+    const ParsedDocument document = ParsedDocument::Parse(corpus.View());
+    const double         treeMs = MeasureMs([&] { static_cast<void>(document.ToTag()); }, Iterations);
+    const bool           roundTrip = document.ToTag().Render() == corpus.View();
+
+    // Compact output leaves out the closing tags that HTML allows to omit, which the parser must
+    // infer for the tree to come back the same.
+    const RenderOptions minified {.Style = RenderOptions::Format::Minified};
+    const RenderOptions compact {.Style                   = RenderOptions::Format::Minified,
+                                 .OmitOptionalClosingTags = true};
+    bool                compactRoundTrip = true;
+    for (const Tag& tag : {Tag {Ul {Li {P {"Some text"}}, Li {"Some more"}}}, BuildLargePage(100)})
+    {
+        compactRoundTrip = compactRoundTrip &&
+                           ParsedDocument::Parse(tag.Render(compact)).ToTag().Render(minified) ==
+                             tag.Render(minified);
+    }
+
+    std::cout << "Parsing a mapped corpus of " << corpus.size() << " bytes, " << nodes
+              << " nodes:\n"
+              << "  flat view:  " << parseMs << " ms, " << throughput(parseMs) << " MB/s\n"
+              << "  tag tree:   " << parseMs + treeMs << " ms, "
+              << throughput(parseMs + treeMs) << " MB/s\n"
+              << "  re-rendered tree " << (roundTrip ? "matches" : "differs from")
+              << " the corpus\n"
+              << "  compact output " << (compactRoundTrip ? "parses back" : "does not parse back")
+              << " to the same tree\n";
+}
+
+long MinorPageFaults()
+{
+    rusage usage {};
+    ::getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_minflt;
+}
+
+void BenchmarkBinaryDocument()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 10;
+
+    char      path[] = "/tmp/groovy_builder_documentXXXXXX";
+    const int fd     = ::mkstemp(path);
+    if (fd < 0)
+    {
+        std::cout << "Unable to create the document file, skipping the binary document benchmark\n";
+        return;
+    }
+    ::close(fd);
+    SaveBinaryDocument(FlatDocument::FromTag(BuildLargePage(Sections)).View(), path);
+
+    std::cout << "Getting a page of " << Sections << " sections ready to render:\n";
+
+    CountingResource heap;
+    const double     buildMs = MeasureMs(
+      [&heap]
+      {
+          ScopedTagResource scope {&heap};
+          static_cast<void>(BuildLargePage(Sections));
+      },
+      Iterations);
+
+    long         faults = 0;
+    const double loadMs = MeasureMs(
+      [&]
+      {
+          const long           before = MinorPageFaults();
+          const BinaryDocument document {path};
+          faults += MinorPageFaults() - before;
+      },
+      Iterations);
+
+    const BinaryDocument document {path};
+    const double         renderMs = MeasureMs([&] { static_cast<void>(document.Render()); }, Iterations);
+    const double         partMs   = MeasureMs(
+      [&] { static_cast<void>(document.ToTag(document.View().Nodes[0].FirstChild)); }, Iterations);
+    ::unlink(path);
+
+    std::cout << "  built from code:    " << buildMs << " ms, " << heap.Allocations() / Iterations
+              << " allocations\n"
+              << "  loaded from file:   " << loadMs << " ms, " << faults / Iterations
+              << " page faults\n"
+              << "  rendered from file: " << renderMs << " ms\n"
+              << "  head materialized:  " << partMs << " ms\n";
+}
+
+struct PageRow
+{
+    std::string Title;
+    std::string Heading;
+    std::string ImageUrl;
+};
+
+Tag BuildRowPage(std::string_view title, std::string_view heading, std::string_view imageUrl)
+{
+    // clang-format off
+    return Html {
+        Head {
+            Title {title}
+        },
+        Body {
+            H1 {heading},
+            H2 {"My Subtitle"},
+            P {"Some text"},
+            Img {imageUrl},
+            Blockquote {
+                "This is my image",
+                "This is my source"
+            }
+        }
+    };
+    // clang-format on
+}
+
+void BenchmarkCompiledTemplate()
+{
+    static constexpr int Rows       = 100000;
+    static constexpr int Iterations = 5;
+
+    std::vector<PageRow> rows;
+    rows.reserve(Rows);
+    for (int i = 0; i < Rows; ++i)
+    {
+        rows.push_back({"Page " + std::to_string(i),
+                        "Title & subtitle " + std::to_string(i),
+                        "link/to/image_" + std::to_string(i) + ".jpg"});
+    }
+
+    const auto compiled = CompiledTemplate::Compile(
+      BuildRowPage(Placeholder("title"), Placeholder("heading"), Placeholder("image")));
+    const auto binding = compiled.Bind<PageRow>(SlotBinding {"title", &PageRow::Title},
+                                                SlotBinding {"heading", &PageRow::Heading},
+                                                SlotBinding {"image", &PageRow::ImageUrl});
+
+    std::cout << "Rendering the page for " << Rows << " rows:\n";
+
+    std::string  treeOut;
+    const double treeMs = MeasureMs(
+      [&]
+      {
+          treeOut.clear();
+          for (const auto& row : rows)
+          {
+              BuildRowPage(row.Title, row.Heading, row.ImageUrl).RenderTo(treeOut);
+          }
+      },
+      Iterations);
+
+    std::string  rowOut;
+    const double rowMs = MeasureMs(
+      [&]
+      {
+          rowOut.clear();
+          for (const auto& row : rows)
+          {
+              binding.RenderTo(rowOut, row);
+          }
+      },
+      Iterations);
+
+    std::string  batchOut;
+    const double batchMs = MeasureMs(
+      [&]
+      {
+          batchOut.clear();
+          binding.RenderBatch(batchOut, rows);
+      },
+      Iterations);
+
+    std::cout << "  tree per row:      " << treeMs << " ms\n"
+              << "  template per row:  " << rowMs << " ms\n"
+              << "  template in batch: " << batchMs << " ms, " << batchOut.size() << " bytes, "
+              << (batchOut == treeOut && rowOut == treeOut ? "identical" : "different")
+              << " output\n";
+}
+
+void BenchmarkGeneratedChildren()
+{
+    static constexpr int Items = 1000000;
+
+    const auto item = [](int i) { return Li {"This is item number " + std::to_string(i)}; };
+    const int  fd   = ::open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        std::cout << "Unable to open /dev/null, skipping the generated children benchmark\n";
+        return;
+    }
+
+    std::cout << "Streaming a list of " << Items << " items to /dev/null:\n";
+
+    CountingResource heap;
+    const double     storedMs = MeasureMs(
+      [&]
+      {
+          ScopedTagResource     scope {&heap};
+          std::pmr::vector<Tag> items {Tag::allocator_type {&heap}};
+          items.reserve(Items);
+          for (int i = 0; i < Items; ++i)
+          {
+              items.push_back(item(i));
+          }
+          RenderStream(Tag {TagId::Ul, std::move(items)}, FdSink {fd});
+      },
+      1);
+    const std::size_t storedPeak = heap.PeakBytesInUse();
+
+    heap.ResetCounters();
+    const double generatedMs = MeasureMs(
+      [&]
+      {
+          ScopedTagResource scope {&heap};
+          RenderStream(Ul {std::views::iota(0, Items) | std::views::transform(item)}, FdSink {fd});
+      },
+      1);
+    const std::size_t generatedPeak = heap.PeakBytesInUse();
+
+    std::cout << "  stored children:    " << storedMs << " ms, " << storedPeak
+              << " bytes of tags at most\n"
+              << "  generated children: " << generatedMs << " ms, " << generatedPeak
+              << " bytes of tags at most\n";
+
+    ::close(fd);
+}
+
+void BenchmarkPullRendering()
+{
+    static constexpr int         Sections   = 10000;
+    static constexpr int         Iterations = 10;
+    static constexpr std::size_t ChunkSize  = 16 * 1024;
+
+    const Tag page = BuildLargePage(Sections);
+    const int fd   = ::open("/dev/null", O_WRONLY);
+    if (fd < 0)
+    {
+        std::cout << "Unable to open /dev/null, skipping the pull rendering benchmark\n";
+        return;
+    }
+
+    std::cout << "Writing a page of " << page.RenderedSize() << " bytes to /dev/null in chunks of "
+              << ChunkSize << " bytes:\n";
+
+    const FdSink sink {fd};
+    const double pushMs = MeasureMs([&] { RenderStream(page, sink, ChunkSize); }, Iterations);
+
+    // Other work, such as polling sockets, would go in between the chunks.
+    std::size_t  chunks = 0;
+    const double pullMs = MeasureMs(
+      [&]
+      {
+          auto renderer = RenderChunks(page, ChunkSize);
+          while (const std::string_view* chunk = renderer.Next())
+          {
+              sink(*chunk);
+              ++chunks;
+          }
+      },
+      Iterations);
+
+    std::cout << "  pushed to the sink:     " << pushMs << " ms\n"
+              << "  pulled by the caller:   " << pullMs << " ms, " << chunks / Iterations
+              << " chunks\n";
+
+    ::close(fd);
+}
+
+void BenchmarkQueries()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 20;
+
+    Tag page = BuildLargePage(Sections);
+    // A tag may carry the same attribute twice, the index must still find it once.
+    page.Children.emplace_back(P {"Twice"});
+    page.Children.back().Attributes.emplace_back(AttributeId::Class, "twice");
+    page.Children.back().Attributes.emplace_back(AttributeId::Class, "twice");
+
+    TagIndex     index {page};
+    const double indexMs = MeasureMs([&] { TagIndex {page}; }, Iterations);
+
+    std::cout << "Querying a page of " << index.NodeCount() << " tags, index built in " << indexMs
+              << " ms:\n";
+    for (const char* text : {"img[src='link/to/image_5000.jpg']",
+                             "section > blockquote[cite]",
+                             "p abbr",
+                             "p[class]",
+                             "[class='twice']"})
+    {
+        const Selector selector {text};
+        std::size_t    found = 0;
+        const double   walkMs =
+          MeasureMs([&] { found = QueryAll(page, selector).size(); }, Iterations);
+        const double indexedMs =
+          MeasureMs([&] { found = index.QueryAll(selector).size(); }, Iterations);
+        const bool same = QueryAll(page, selector) == index.QueryAll(selector);
+        std::cout << "  " << text << ": " << found << " tags, walked in " << walkMs
+                  << " ms, indexed in " << indexedMs << " ms, "
+                  << (same ? "same tags" : "different tags") << "\n";
+    }
+}
+// A page of a site: only the heading and the content differ from one page to the next.
+Tag BuildSitePage(int page)
+{
+    static constexpr int Links = 50;
+
+    Ul links;
+    links.Children.reserve(Links);
+    for (int i = 0; i < Links; ++i)
+    {
+        links.Children.emplace_back(Li {"Link to page " + std::to_string(i)});
+    }
+
+    // clang-format off
+    return Html {
+        Head {
+            Title {"My Site"}
+        },
+        Body {
+            Tag {"nav", std::move(links)},
+            H1 {"Page " + std::to_string(page)},
+            P {"Content of page " + std::to_string(page)},
+            Tag {"footer", P {"Some footer text"}, Hr {}}
+        }
+    };
+    // clang-format on
+}
+
+void BenchmarkSharedSubtrees()
+{
+    static constexpr int Pages      = 1000;
+    static constexpr int Iterations = 5;
+
+    CountingResource deepHeap;
+    std::vector<Tag> deepPages;
+    deepPages.reserve(Pages);
+    {
+        ScopedTagResource scope {&deepHeap};
+        for (int i = 0; i < Pages; ++i)
+        {
+            deepPages.push_back(BuildSitePage(i));
+        }
+    }
+
+    CountingResource       sharedHeap;
+    SubtreeStore           store {&sharedHeap};
+    std::vector<SharedTag> sharedPages;
+    sharedPages.reserve(Pages);
+    for (int i = 0; i < Pages; ++i)
+    {
+        sharedPages.push_back(store.Intern(BuildSitePage(i)));
+    }
+
+    std::string  out;
+    const double deepMs = MeasureMs(
+      [&]
+      {
+          for (const Tag& page : deepPages)
+          {
+              out.clear();
+              page.RenderTo(out);
+          }
+      },
+      Iterations);
+    const double sharedMs = MeasureMs(
+      [&]
+      {
+          for (SharedTag page : sharedPages)
+          {
+              out.clear();
+              store.RenderTo(out, page);
+          }
+      },
+      Iterations);
+
+    std::cout << "Storing and rendering " << Pages << " pages of a site:\n"
+              << "  deep copies:     " << deepHeap.PeakBytesInUse() << " bytes, " << deepMs
+              << " ms\n"
+              << "  shared subtrees: " << sharedHeap.PeakBytesInUse() << " bytes, "
+              << store.UniqueCount() << " unique tags, " << store.FragmentCount()
+              << " cached fragments, " << sharedMs << " ms\n";
+}
+
+void BenchmarkTreeDiff()
+{
+    static constexpr int Sections   = 10000;
+    static constexpr int Iterations = 20;
+
+    // Sections have an id, so that they can be paired up wherever they are.
+    Tag before = BuildLargePage(Sections);
+    for (std::size_t i = 0; auto& section : before.Children.back().Children)
+    {
+        section.Attributes.emplace_back(AttributeId::Id, "section-" + std::to_string(i++));
+    }
+
+    Tag   after = before;
+    auto& body  = after.Children.back().Children;
+    body[10].Children.front().Text = "A new title";
+    body[5000].Attributes.emplace_back(AttributeId::Class, "highlighted");
+    body.erase(body.begin() + 7000);
+    body.push_back(Tag {"section", H2 {"A new section"}, P {"With some new text"}});
+
+    // The sizes are added up, so that the renders can't be optimized away.
+    std::size_t  renderedBytes = 0;
+    const double renderMs      = MeasureMs([&] { renderedBytes += after.Render().size(); }, Iterations);
+    std::cout << "Diffing a page of " << Sections << " sections after 4 edits:\n"
+              << "  whole page:  " << renderedBytes / Iterations << " bytes, rendered in "
+              << renderMs << " ms\n";
+
+    for (const bool byId : {false, true})
+    {
+        Patch        patch;
+        const double diffMs =
+          MeasureMs([&] { patch = Patch::Diff(before, after, {.MatchById = byId}); }, Iterations);
+        const std::string serialized = patch.Serialize();
+
+        Tag          patched = before;
+        const double applyMs = MeasureMs([&] { Patch::Parse(serialized).ApplyTo(patched); }, 1);
+
+        std::cout << (byId ? "  by id:       " : "  by position: ") << patch.Operations.size()
+                  << " operations, " << serialized.size() << " bytes, diffed in " << diffMs
+                  << " ms, applied in " << applyMs << " ms\n";
+    }
+}
+void BenchmarkTypedDocument()
+{
+    static constexpr int Iterations = 100000;
+
+    std::string  out;
+    const double tagMs = MeasureMs(
+      [&out]
+      {
+          out.clear();
+          BuildRowPage("My Page", "My Title", "link/to/an/image.jpg").RenderTo(out);
+      },
+      Iterations);
+
+    const double typedMs = MeasureMs(
+      [&out]
+      {
+          out.clear();
+          // clang-format off
+          Typed::Html {
+              Typed::Head {
+                  Typed::Title {"My Page"}
+              },
+              Typed::Body {
+                  Typed::H1 {"My Title"},
+                  Typed::H2 {"My Subtitle"},
+                  Typed::P {"Some text"},
+                  Typed::Img {"link/to/an/image.jpg"},
+                  Typed::Blockquote {
+                      "This is my image",
+                      "This is my source"
+                  }
+              }
+          }.RenderTo(out);
+          // clang-format on
+      },
+      Iterations);
+
+    std::cout << "Building and rendering the page of groovy_builder.cpp:\n"
+              << "  Tag tree:       " << tagMs * 1000 << " us\n"
+              << "  typed document: " << typedMs * 1000 << " us\n";
+}
+}    // namespace
+
+int main()
+{
+    BenchmarkConstruction();
+    BenchmarkArena();
+    BenchmarkFlatDocument();
+    BenchmarkStaticDocument();
+    BenchmarkStreaming();
+    BenchmarkEscaping();
+    BenchmarkLiveDocument();
+    BenchmarkParallelRendering();
+    BenchmarkMinifiedRendering();
+    BenchmarkParsing();
+    BenchmarkBinaryDocument();
+    BenchmarkCompiledTemplate();
+    BenchmarkGeneratedChildren();
+    BenchmarkPullRendering();
+    BenchmarkQueries();
+    BenchmarkSharedSubtrees();
+    BenchmarkTreeDiff();
+    BenchmarkTypedDocument();
+    return 0;
+}